@@ -0,0 +1,205 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "src/corpus.hpp"
+#include "src/runner.hpp"
+
+#include <bourne/compiled_pointer.hpp>
+#include <bourne/json.hpp>
+#include <bourne/json_path.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Returns the JSON pointer to the member of the root object with the key
+std::string pointer_to(const std::string& key)
+{
+    std::string pointer = "/";
+    for (char c : key)
+    {
+        if (c == '~')
+            pointer += "~0";
+        else if (c == '/')
+            pointer += "~1";
+        else
+            pointer += c;
+    }
+    return pointer;
+}
+
+void run_document(benchmark::runner& runner,
+                  const benchmark::document& document)
+{
+    const std::string& name = document.m_name;
+    const std::string& text = document.m_text;
+
+    runner.run(name, "parse", text.size(), 1, [&]
+               { return std::size_t(bourne::json::parse(text).json_type()); });
+
+    const bourne::json value = bourne::json::parse(text);
+    const std::size_t dump_size = value.dump().size();
+    const std::size_t dump_min_size = value.dump_min().size();
+
+    runner.run(name, "dump", dump_size, 1,
+               [&] { return value.dump().size(); });
+    runner.run(name, "dump_min", dump_min_size, 1,
+               [&] { return value.dump_min().size(); });
+    runner.run(name, "copy", dump_min_size, 1,
+               [&]
+               {
+                   bourne::json copy(value);
+                   return std::size_t(copy.json_type());
+               });
+    runner.run(name, "share", dump_min_size, 1,
+               [&]
+               {
+                   bourne::json shared = value.share();
+                   return std::size_t(shared.json_type());
+               });
+
+    const bourne::json copy(value);
+    runner.run(name, "equal", dump_min_size, 1,
+               [&] { return std::size_t(value == copy); });
+
+    // Searching for a value which is not nested visits every value
+    const bourne::json other;
+    runner.run(name, "contains", dump_min_size, 1,
+               [&] { return std::size_t(value.contains(other)); });
+
+    if (value.is_object())
+    {
+        const std::vector<std::string> keys = value.keys();
+        runner.run(name, "lookup", 0, keys.size(),
+                   [&]
+                   {
+                       std::size_t found = 0;
+                       for (const auto& key : keys)
+                       {
+                           found += std::size_t(value[key].json_type());
+                       }
+                       return found;
+                   });
+
+        std::vector<bourne::compiled_pointer> pointers;
+        for (const auto& key : keys)
+        {
+            pointers.push_back(
+                bourne::compiled_pointer::parse(pointer_to(key)));
+        }
+        runner.run(name, "pointer", 0, pointers.size(),
+                   [&]
+                   {
+                       std::size_t found = 0;
+                       for (const auto& pointer : pointers)
+                       {
+                           found += std::size_t(
+                               value.at_pointer(pointer).json_type());
+                       }
+                       return found;
+                   });
+    }
+
+    // A selective query reads a single value of the document
+    std::string selective;
+    if (value.is_array() && value.size() > 0)
+    {
+        selective = "$[0]";
+    }
+    else if (value.is_object() && value.size() > 0)
+    {
+        const std::string key = value.keys().front();
+        selective = "$['";
+        for (char c : key)
+        {
+            if (c == '\'' || c == '\\')
+                selective += '\\';
+            selective += c;
+        }
+        selective += "']";
+    }
+
+    if (!selective.empty())
+    {
+        const auto path = bourne::json_path::parse(selective);
+        runner.run(name, "path", 0, 1,
+                   [&] { return path.select(value).size(); });
+        runner.run(name, "path_input", text.size(), 1,
+                   [&] { return path.select_input(text).size(); });
+    }
+}
+}
+
+/// Runs the benchmarks and prints the results. The options are:
+///
+///     --output=<path>     Writes the results as json to the path
+///     --filter=<name>     Only runs benchmarks with a "document/operation"
+///                         name containing the filter
+///     --min-time=<ms>     The time each repetition runs at least,
+///                         100 ms by default
+///     --corpus=<path>     The json file benchmarked with the generated
+///                         documents, test.json by default
+int main(int argc, char** argv)
+{
+    std::string output;
+    std::string filter;
+    std::string corpus = "test.json";
+    long min_time = 100;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const auto separator = argument.find('=');
+        const std::string option = argument.substr(0, separator);
+        const std::string value = separator == std::string::npos
+                                      ? std::string()
+                                      : argument.substr(separator + 1);
+        if (option == "--output")
+        {
+            output = value;
+        }
+        else if (option == "--filter")
+        {
+            filter = value;
+        }
+        else if (option == "--min-time")
+        {
+            min_time = std::strtol(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--corpus")
+        {
+            corpus = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::runner runner(std::chrono::milliseconds(min_time), filter);
+    for (const auto& document : benchmark::corpus(corpus))
+    {
+        run_document(runner, document);
+    }
+
+    if (!output.empty())
+    {
+        std::ofstream file(output);
+        runner.to_json().dump_to(file);
+        file << std::endl;
+        if (!file)
+        {
+            std::cerr << "Could not write " << output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+namespace benchmark
+{
+/// @return The number of calls of the global operator new so far. The
+///         operator is replaced by the benchmarks to count its calls.
+uint64_t allocation_count();
+}
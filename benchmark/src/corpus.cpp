@@ -0,0 +1,176 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "corpus.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace benchmark
+{
+namespace
+{
+/// The raw output of std::mt19937 is specified by the standard, unlike the
+/// distributions, so the documents are the same with every standard library
+class generator
+{
+public:
+    /// @return A number in the range [0, bound)
+    uint32_t next(uint32_t bound)
+    {
+        return uint32_t(m_engine() % bound);
+    }
+
+private:
+    std::mt19937 m_engine{42};
+};
+
+std::string deep_nesting()
+{
+    // Alternating objects and arrays nested 1000 levels deep
+    const int depth = 1000;
+    std::string text;
+    for (int i = 0; i < depth; ++i)
+    {
+        text += i % 2 == 0 ? "{\"level\": " + std::to_string(i) + ", \"next\": "
+                           : "[true, ";
+    }
+    text += "null";
+    for (int i = depth - 1; i >= 0; --i)
+    {
+        text += i % 2 == 0 ? "}" : "]";
+    }
+    return text;
+}
+
+std::string wide_object(generator& random)
+{
+    std::string text = "{";
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        if (i != 0)
+            text += ", ";
+        text += "\"key_" + std::to_string(random.next(1000000000)) + "_" +
+                std::to_string(i) + "\": ";
+        switch (random.next(4))
+        {
+        case 0:
+            text += std::to_string(random.next(100000));
+            break;
+        case 1:
+            text += "\"value " + std::to_string(i) + "\"";
+            break;
+        case 2:
+            text += random.next(2) ? "true" : "false";
+            break;
+        default:
+            text += "null";
+            break;
+        }
+    }
+    return text + "}";
+}
+
+std::string numeric_array(generator& random)
+{
+    std::string text = "[";
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        if (i != 0)
+            text += ", ";
+        const std::string integer =
+            std::to_string(10 + random.next(2000000000));
+        switch (random.next(3))
+        {
+        case 0:
+            text += integer;
+            break;
+        case 1:
+            text += "-" + integer + "." + std::to_string(random.next(1000));
+            break;
+        default:
+            text += integer.substr(0, 1) + "." + integer.substr(1) + "e-" +
+                    std::to_string(random.next(300));
+            break;
+        }
+    }
+    return text + "]";
+}
+
+std::string string_heavy(generator& random)
+{
+    const char* escapes[] = {"\\\"", "\\\\", "\\n", "\\t", "\\/"};
+    std::string text = "[";
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        if (i != 0)
+            text += ", ";
+        text += "\"";
+        const uint32_t length = 10 + random.next(190);
+        for (uint32_t j = 0; j < length; ++j)
+        {
+            if (random.next(50) == 0)
+            {
+                text += escapes[random.next(5)];
+            }
+            else
+            {
+                text += char(' ' + 1 + random.next(90));
+                if (text.back() == '"' || text.back() == '\\')
+                    text.back() = 'x';
+            }
+        }
+        text += "\"";
+    }
+    return text + "]";
+}
+
+std::string unicode_heavy(generator& random)
+{
+    // Two, three and four byte UTF-8 characters and \u escapes
+    const char* characters[] = {"\xc3\xa6",         "\xc3\xb8",
+                                "\xe2\x82\xac",     "\xe4\xb8\xad",
+                                "\xf0\x9f\x98\x80", "\\u00e5",
+                                "\\u6587",          "\\ud83d\\ude00",
+                                "a"};
+    std::string text = "[";
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        if (i != 0)
+            text += ", ";
+        text += "\"";
+        const uint32_t length = 5 + random.next(60);
+        for (uint32_t j = 0; j < length; ++j)
+        {
+            text += characters[random.next(9)];
+        }
+        text += "\"";
+    }
+    return text + "]";
+}
+}
+
+std::vector<document> corpus(const std::string& path)
+{
+    generator random;
+    std::vector<document> documents;
+    documents.push_back({"deep_nesting", deep_nesting()});
+    documents.push_back({"wide_object", wide_object(random)});
+    documents.push_back({"numeric_array", numeric_array(random)});
+    documents.push_back({"string_heavy", string_heavy(random)});
+    documents.push_back({"unicode_heavy", unicode_heavy(random)});
+
+    std::ifstream file(path, std::ios::binary);
+    if (file)
+    {
+        documents.push_back({"test_json",
+                             std::string(std::istreambuf_iterator<char>(file),
+                                         std::istreambuf_iterator<char>())});
+    }
+    return documents;
+}
+}
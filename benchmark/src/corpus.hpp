@@ -0,0 +1,24 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+/// A json document benchmarked
+struct document
+{
+    std::string m_name;
+    std::string m_text;
+};
+
+/// @return The generated documents followed by the document in the file at
+///         the path, if it can be read. The documents are generated from a
+///         fixed seed, so they are the same in every run.
+std::vector<document> corpus(const std::string& path);
+}
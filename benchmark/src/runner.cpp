@@ -0,0 +1,67 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "runner.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+namespace benchmark
+{
+runner::runner(std::chrono::nanoseconds min_time, std::string filter) :
+    m_min_time(min_time), m_filter(std::move(filter))
+{
+}
+
+const std::vector<result>& runner::results() const
+{
+    return m_results;
+}
+
+bourne::json runner::to_json() const
+{
+    bourne::json results = bourne::json::array();
+    for (const auto& result : m_results)
+    {
+        bourne::json entry = bourne::json::object();
+        entry["document"] = result.m_document;
+        entry["operation"] = result.m_operation;
+        entry["bytes"] = int64_t(result.m_bytes);
+        entry["operations"] = int64_t(result.m_operations);
+        entry["ns_per_op"] = result.m_ns_per_op;
+        entry["mb_per_s"] = result.mb_per_s();
+        entry["allocations_per_op"] = result.m_allocations_per_op;
+        results.append(entry);
+    }
+
+    bourne::json output = bourne::json::object();
+    output["min_time_ms"] =
+        std::chrono::duration<double, std::milli>(m_min_time).count();
+    output["repetitions"] = repetitions;
+    output["results"] = results;
+    return output;
+}
+
+void runner::add(const result& result)
+{
+    m_results.push_back(result);
+
+    std::cout << std::left << std::setw(16) << result.m_document
+              << std::setw(12) << result.m_operation << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << result.m_ns_per_op << " ns/op";
+    if (result.m_bytes != 0)
+    {
+        std::cout << std::setw(10) << result.mb_per_s() << " MB/s";
+    }
+    else
+    {
+        std::cout << std::setw(15) << "";
+    }
+    std::cout << std::setprecision(2) << std::setw(12)
+              << result.m_allocations_per_op << " allocs/op" << std::endl;
+}
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "allocation_counter.hpp"
+
+#include <bourne/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+/// The measurements of an operation on a document
+struct result
+{
+    std::string m_document;
+    std::string m_operation;
+
+    /// The bytes processed per operation, or zero if the throughput is not
+    /// meaningful for the operation
+    std::size_t m_bytes;
+
+    /// The operations timed in each repetition
+    uint64_t m_operations;
+
+    double m_ns_per_op;
+    double m_allocations_per_op;
+
+    /// @return The throughput in MB/s, or zero if m_bytes is zero
+    double mb_per_s() const
+    {
+        return m_ns_per_op > 0 ? m_bytes * 1e3 / m_ns_per_op : 0.0;
+    }
+};
+
+/// Runs the benchmarks and collects their results.
+///
+/// Each benchmark is first run with a doubling number of iterations until a
+/// batch takes long enough to time reliably. The batch is then repeated and
+/// the fastest repetition is reported, which is the least disturbed by the
+/// rest of the system and so the most reproducible.
+class runner
+{
+public:
+    /// @param min_time The time each repetition should take at least
+    /// @param filter Only benchmarks whose "document/operation" name
+    ///        contains the filter are run
+    runner(std::chrono::nanoseconds min_time, std::string filter);
+
+    /// Runs the function, which performs the given number of operations on
+    /// each call and returns a value depending on its work, so it is not
+    /// optimized away.
+    template <class Function>
+    void run(const std::string& document, const std::string& operation,
+             std::size_t bytes, std::size_t operations, Function function)
+    {
+        if ((document + "/" + operation).find(m_filter) == std::string::npos)
+            return;
+
+        uint64_t iterations = 1;
+        while (time(function, iterations) < m_min_time &&
+               iterations < (uint64_t(1) << 30))
+        {
+            iterations *= 2;
+        }
+
+        double fastest = std::numeric_limits<double>::max();
+        uint64_t allocations = 0;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            const uint64_t before = allocation_count();
+            const auto elapsed = time(function, iterations);
+            allocations = allocation_count() - before;
+            fastest = std::min(fastest, double(elapsed.count()));
+        }
+
+        const double total = double(iterations * operations);
+        add({document, operation, bytes, iterations * operations,
+             fastest / total, allocations / total});
+    }
+
+    /// @return The results of the benchmarks run
+    const std::vector<result>& results() const;
+
+    /// @return The results as json, to compare them between runs
+    bourne::json to_json() const;
+
+private:
+    template <class Function>
+    std::chrono::nanoseconds time(Function& function, uint64_t iterations)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            m_sink += function();
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    /// Stores and prints a result
+    void add(const result& result);
+
+private:
+    static constexpr int repetitions = 5;
+
+    std::chrono::nanoseconds m_min_time;
+    std::string m_filter;
+    std::vector<result> m_results;
+
+    /// Accumulates the values returned by the benchmarks
+    volatile std::size_t m_sink = 0;
+};
+}
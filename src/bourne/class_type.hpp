@@ -7,11 +7,13 @@
 
 #include "version.hpp"
 
+#include <cstdint>
+
 namespace bourne
 {
 inline namespace STEINWURF_BOURNE_VERSION
 {
-enum class class_type
+enum class class_type : uint8_t
 {
     null,
     object,
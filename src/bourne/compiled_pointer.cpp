@@ -0,0 +1,57 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "compiled_pointer.hpp"
+
+#include "detail/pointer.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+compiled_pointer::compiled_pointer()
+{
+}
+
+std::size_t compiled_pointer::size() const
+{
+    return m_tokens.size();
+}
+
+const std::string& compiled_pointer::to_string() const
+{
+    return m_pointer;
+}
+
+compiled_pointer compiled_pointer::parse(std::string_view pointer,
+                                         std::error_code& error)
+{
+    assert(!error);
+    compiled_pointer result;
+    std::string buffer;
+    detail::for_each_pointer_token(
+        pointer, buffer, error,
+        [&result](std::string_view key, std::size_t index)
+        { result.m_tokens.push_back({std::string(key), index}); });
+
+    if (error)
+        return compiled_pointer();
+
+    result.m_pointer = std::string(pointer);
+    return result;
+}
+
+compiled_pointer compiled_pointer::parse(std::string_view pointer)
+{
+    std::error_code error;
+    auto result = parse(pointer, error);
+    throw_if_error(error);
+    return result;
+}
+}
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+class json;
+
+/// An RFC 6901 JSON pointer, such as "/servers/0/port", split into its
+/// reference tokens once so it can be looked up many times.
+///
+/// Looking up a compiled pointer with json::at_pointer() only walks the
+/// tree: the keys are already unescaped and the array indices already
+/// parsed, so a lookup neither allocates nor modifies the value.
+///
+///     auto port = bourne::compiled_pointer::parse("/servers/0/port");
+///
+///     for (const auto& config : configs)
+///         std::cout << config.at_pointer(port).to_int() << std::endl;
+class compiled_pointer
+{
+public:
+    /// Creates the empty pointer, which refers to the whole value.
+    compiled_pointer();
+
+    /// Returns the number of reference tokens of this pointer.
+    std::size_t size() const;
+
+    /// Returns this pointer as it was parsed.
+    const std::string& to_string() const;
+
+    /// Parses a JSON pointer. Fails with bourne::error::pointer_invalid_syntax
+    /// if the pointer is not empty and does not start with "/", or contains
+    /// a "~" which is not followed by "0" or "1".
+    static compiled_pointer parse(std::string_view pointer,
+                                  std::error_code& error);
+
+    /// Parses a JSON pointer.
+    static compiled_pointer parse(std::string_view pointer);
+
+private:
+    friend class json;
+
+    /// A reference token of the pointer
+    struct token
+    {
+        /// The unescaped token, used as the key of an object member
+        std::string m_key;
+
+        /// The token as an array index, or detail::no_index if it is not
+        /// one
+        std::size_t m_index;
+    };
+
+private:
+    std::vector<token> m_tokens;
+
+    std::string m_pointer;
+};
+}
+}
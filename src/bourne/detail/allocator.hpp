@@ -0,0 +1,200 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Allocator used by the containers backing json values. It allocates from
+/// an arena if it has one, otherwise from the heap. Memory from an arena is
+/// never released individually.
+///
+/// Copies of a container are always allocated on the heap, so values copied
+/// out of an arena do not depend on its lifetime.
+template <class T>
+class allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    allocator() noexcept = default;
+
+    explicit allocator(detail::arena* arena) noexcept : m_arena(arena)
+    {
+    }
+
+    template <class U>
+    allocator(const allocator<U>& other) noexcept : m_arena(other.arena())
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (m_arena == nullptr)
+            return std::allocator<T>().allocate(n);
+
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept
+    {
+        if (m_arena == nullptr)
+            std::allocator<T>().deallocate(pointer, n);
+    }
+
+    allocator select_on_container_copy_construction() const noexcept
+    {
+        return allocator();
+    }
+
+    /// @return The arena allocated from or nullptr if allocating on the heap
+    detail::arena* arena() const noexcept
+    {
+        return m_arena;
+    }
+
+private:
+    detail::arena* m_arena = nullptr;
+};
+
+template <class T, class U>
+bool operator==(const allocator<T>& a, const allocator<U>& b) noexcept
+{
+    return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const allocator<T>& a, const allocator<U>& b) noexcept
+{
+    return a.arena() != b.arena();
+}
+
+/// The header stored in front of every container created with create().
+/// It counts the values sharing a container on the heap, so values shared
+/// with json::share() can copy the container only when one of them modifies
+/// it. The count is atomic, so values sharing a container can be read and
+/// shared from several threads.
+struct shared_header
+{
+    std::atomic<uint32_t> m_count{1};
+};
+
+/// The offset of a container from the start of its header
+template <class Container>
+constexpr std::size_t header_size =
+    (sizeof(shared_header) + alignof(Container) - 1) / alignof(Container) *
+    alignof(Container);
+
+/// @return The header in front of a container created with create()
+template <class Container>
+shared_header& header(const Container* container)
+{
+    auto memory = reinterpret_cast<const char*>(container);
+    return *reinterpret_cast<shared_header*>(
+        const_cast<char*>(memory - header_size<Container>));
+}
+
+/// Creates a container on the heap after a shared_header
+template <class Container, class... Args>
+Container* create_on_heap(Args&&... args)
+{
+    static_assert(alignof(Container) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Containers must be aligned by operator new");
+    char* memory = static_cast<char*>(
+        ::operator new(header_size<Container> + sizeof(Container)));
+    new (memory) shared_header();
+    try
+    {
+        return new (memory + header_size<Container>)
+            Container(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(memory);
+        throw;
+    }
+}
+
+/// Creates a container using the given arena, or the heap if arena is
+/// nullptr, for both the container itself and its elements.
+template <class Container, class... Args>
+Container* create(detail::arena* arena, Args&&... args)
+{
+    using allocator_type = typename Container::allocator_type;
+    if (arena == nullptr)
+        return create_on_heap<Container>(std::forward<Args>(args)...);
+
+    char* memory = static_cast<char*>(
+        arena->allocate(header_size<Container> + sizeof(Container),
+                        std::max(alignof(shared_header), alignof(Container))));
+    new (memory) shared_header();
+    return new (memory + header_size<Container>)
+        Container(std::forward<Args>(args)..., allocator_type(arena));
+}
+
+/// Releases a container created with create(). Containers on the heap are
+/// destroyed once no value shares them any longer.
+template <class Container>
+void destroy(Container* container)
+{
+    if (container->get_allocator().arena() != nullptr)
+    {
+        container->~Container();
+        return;
+    }
+
+    shared_header& header = detail::header(container);
+    if (header.m_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    container->~Container();
+    header.~shared_header();
+    ::operator delete(&header);
+}
+
+/// @return The container to use for a copy of the value holding it. Heap
+///         containers are shared if share is true, others are copied to the
+///         heap, so copies of values from an arena do not depend on its
+///         lifetime.
+template <class Container>
+Container* copy_or_share(Container* container, bool share)
+{
+    if (share && container->get_allocator().arena() == nullptr)
+    {
+        header(container).m_count.fetch_add(1, std::memory_order_relaxed);
+        return container;
+    }
+    return create_on_heap<Container>(*container);
+}
+
+/// @return True if the container is shared with other values, so it must
+///         be copied before it is modified
+template <class Container>
+bool is_shared(const Container* container)
+{
+    return container->get_allocator().arena() == nullptr &&
+           header(container).m_count.load(std::memory_order_acquire) != 1;
+}
+}
+}
+}
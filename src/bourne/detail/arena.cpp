@@ -0,0 +1,80 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// Blocks stop doubling once they reach this size
+constexpr std::size_t max_block_size = 1024 * 1024;
+}
+
+arena::arena(std::size_t initial_block_size) :
+    m_block_size(std::max<std::size_t>(initial_block_size, 64))
+{
+}
+
+arena::~arena()
+{
+    while (m_blocks != nullptr)
+    {
+        block* next = m_blocks->m_next;
+        ::operator delete(m_blocks);
+        m_blocks = next;
+    }
+}
+
+void* arena::allocate(std::size_t size, std::size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    auto aligned = [&]
+    {
+        auto position = reinterpret_cast<std::uintptr_t>(m_position);
+        return (position + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+    };
+
+    if (m_position == nullptr ||
+        aligned() + size > reinterpret_cast<std::uintptr_t>(m_end))
+    {
+        add_block(size + alignment);
+    }
+
+    auto memory = aligned();
+    m_position = reinterpret_cast<char*>(memory + size);
+    assert(m_position <= m_end);
+    return reinterpret_cast<void*>(memory);
+}
+
+std::size_t arena::capacity() const
+{
+    return m_capacity;
+}
+
+void arena::add_block(std::size_t minimum_size)
+{
+    std::size_t size = std::max(m_block_size, minimum_size);
+    m_block_size = std::min(m_block_size * 2, max_block_size);
+
+    char* memory = static_cast<char*>(::operator new(sizeof(block) + size));
+    m_blocks = new (memory) block{m_blocks};
+    m_position = memory + sizeof(block);
+    m_end = m_position + size;
+    m_capacity += size;
+}
+}
+}
+}
@@ -0,0 +1,61 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstddef>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// A monotonic bump allocator. Memory is handed out from a list of blocks
+/// which grow in size, and is only released when the arena is destroyed.
+class arena
+{
+public:
+    /// Creates an arena, no memory is reserved until the first allocation.
+    /// @param initial_block_size The size of the first block, subsequent
+    ///        blocks double in size.
+    explicit arena(std::size_t initial_block_size = 4096);
+
+    /// Releases all blocks of the arena
+    ~arena();
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    /// @return Memory for size bytes with the given alignment, which must be a
+    ///         power of two.
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /// @return The total number of bytes reserved by the arena
+    std::size_t capacity() const;
+
+private:
+    void add_block(std::size_t minimum_size);
+
+private:
+    struct block
+    {
+        block* m_next;
+    };
+
+    /// The most recently added block, which the others are linked from
+    block* m_blocks = nullptr;
+
+    char* m_position = nullptr;
+    char* m_end = nullptr;
+
+    std::size_t m_block_size;
+    std::size_t m_capacity = 0;
+};
+}
+}
+}
@@ -5,12 +5,17 @@
 
 #pragma once
 
+#include "../class_type.hpp"
 #include "../json.hpp"
+#include "allocator.hpp"
+#include "flat_map.hpp"
+#include "key.hpp"
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace bourne
 {
@@ -24,8 +29,11 @@ namespace detail
 
 union backing_data
 {
-    using object_type = std::map<std::string, json>;
-    using array_type = std::deque<json>;
+    using object_type =
+        flat_map<key, json, allocator<std::pair<const key, json>>>;
+    using array_type = std::vector<json, allocator<json>>;
+    using string_type =
+        std::basic_string<char, std::char_traits<char>, allocator<char>>;
 
     backing_data(double d) : m_float(d)
     {
@@ -36,20 +44,78 @@ union backing_data
     backing_data(bool b) : m_bool(b)
     {
     }
-    backing_data(std::string s) : m_string(new std::string(s))
-    {
-    }
     backing_data() : m_int(0)
     {
     }
 
     array_type* m_array;
     object_type* m_map;
-    std::string* m_string;
+    string_type* m_string;
     double m_float;
     int64_t m_int;
     bool m_bool;
 };
+
+/// Strings of up to this many bytes are stored in the json value itself
+constexpr std::size_t short_string_capacity = 14;
+
+/// The short string size of values which are not short strings
+constexpr uint8_t not_short = 0xff;
+
+/// The short string size of strings which refer to characters they do not
+/// own
+constexpr uint8_t borrowed = 0xfe;
+
+/// The layout of values with their data in backing_data
+struct long_value
+{
+    class_type m_type;
+
+    /// Always not_short
+    uint8_t m_short_size;
+
+    backing_data m_internal;
+};
+
+/// The layout of strings stored in the json value itself
+struct short_value
+{
+    /// Always class_type::string
+    class_type m_type;
+
+    uint8_t m_short_size;
+
+    char m_data[short_string_capacity];
+};
+
+/// The layout of strings referring to characters owned by someone else,
+/// such as the input they were parsed from
+struct borrowed_value
+{
+    /// Always class_type::string
+    class_type m_type;
+
+    /// Always borrowed
+    uint8_t m_short_size;
+
+    uint32_t m_size;
+
+    const char* m_data;
+};
+
+/// The data of a json value in one of the three layouts. Since the layouts
+/// start with the same members, the type and short string size can be read
+/// through m_long whichever layout is in use.
+union node
+{
+    node() : m_long{class_type::null, not_short, backing_data()}
+    {
+    }
+
+    long_value m_long;
+    short_value m_short;
+    borrowed_value m_borrowed;
+};
 }
 }
 }
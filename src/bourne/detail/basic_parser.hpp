@@ -0,0 +1,571 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../error.hpp"
+#include "number.hpp"
+#include "simd.hpp"
+#include "structural_index.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Detects handlers with the member function reserve(std::size_t), which is
+/// called with the number of elements of an array or members of an object
+/// after it begins, when the parser knows it in advance.
+template <class Handler, class = void>
+struct has_reserve : std::false_type
+{
+};
+
+template <class Handler>
+struct has_reserve<Handler, std::void_t<decltype(std::declval<Handler&>()
+                                                     .reserve(std::size_t()))>>
+    : std::true_type
+{
+};
+
+/// The recursive descent json parser. Instead of building json values it
+/// reports what it finds to a handler, which has the same callbacks as
+/// bourne::handler. The handler may be bourne::handler itself or a class
+/// with matching non-virtual member functions.
+template <class Handler>
+class basic_parser
+{
+public:
+    /// @param index The structural index of the input for the two-stage
+    ///        parser, or nullptr to parse in a single stage.
+    basic_parser(std::string_view input, Handler& handler,
+                 std::error_code& error, const structural_index* index) :
+        m_input(input), m_handler(handler), m_error(error), m_index(index)
+    {
+    }
+
+    /// Parses a single value which may only be surrounded by white space
+    void parse_document()
+    {
+        parse_next();
+        if (m_error)
+            return;
+        consume_white_space();
+        if (m_offset != m_input.size())
+        {
+            m_error = bourne::error::parse_found_multiple_unstructured_elements;
+            return;
+        }
+        assert(m_offset == m_input.size());
+    }
+
+    /// Parses a single value at the start of the input.
+    /// @return The offset following the value
+    std::size_t parse_value()
+    {
+        parse_next();
+        return m_offset;
+    }
+
+    /// Parses a single object key at the start of the input.
+    /// @return The offset following the key
+    std::size_t parse_key()
+    {
+        assert(peek(m_offset) == '\"');
+        parse_string(true);
+        return m_offset;
+    }
+
+private:
+    /// Stops parsing if a handler callback returned false, unless the
+    /// handler already reported an error itself.
+    void handle(bool keep_going)
+    {
+        if (!keep_going && !m_error)
+            m_error = bourne::error::parse_stopped_by_handler;
+    }
+
+    /// Returns the byte at the offset, or zero past the end of the input
+    char peek(std::size_t offset) const
+    {
+        return offset < m_input.size() ? m_input[offset] : '\0';
+    }
+
+    /// Passes the size of the container just begun to the handler, if the
+    /// structural index has counted it
+    void reserve()
+    {
+        if (m_index == nullptr)
+            return;
+
+        // Containers are parsed in the order they were counted
+        const auto& sizes = m_index->container_sizes();
+        assert(m_container_position < sizes.size());
+        const std::size_t size = sizes[m_container_position++];
+        if constexpr (has_reserve<Handler>::value)
+            m_handler.reserve(size);
+    }
+
+    void consume_white_space()
+    {
+        if (m_offset >= m_input.size() || !is_white_space(m_input[m_offset]))
+            return;
+
+        if (m_index != nullptr)
+        {
+            // White space is never indexed, so the next non-white space byte
+            // is the next entry in the index.
+            const auto& offsets = m_index->offsets();
+            while (offsets[m_index_position] < m_offset)
+            {
+                m_index_position++;
+            }
+            m_offset = offsets[m_index_position];
+            return;
+        }
+
+        while (m_offset < m_input.size() && is_white_space(m_input[m_offset]))
+        {
+            m_offset++;
+        }
+    }
+
+    void parse_object()
+    {
+        assert(!m_error);
+        m_offset++;
+        handle(m_handler.on_object_begin());
+        if (m_error)
+            return;
+        reserve();
+
+        consume_white_space();
+        if (peek(m_offset) == '}')
+        {
+            m_offset++;
+            handle(m_handler.on_object_end());
+            return;
+        }
+
+        while (true)
+        {
+            consume_white_space();
+            if (peek(m_offset) != '\"')
+            {
+                m_error = bourne::error::parse_next_unexpected_char;
+                return;
+            }
+            parse_string(true);
+            if (m_error)
+                return;
+
+            consume_white_space();
+            if (peek(m_offset) != ':')
+            {
+                m_error = bourne::error::parse_object_expected_colon;
+                return;
+            }
+            m_offset++;
+            consume_white_space();
+            parse_next();
+            if (m_error)
+                return;
+
+            consume_white_space();
+            if (peek(m_offset) == ',')
+            {
+                m_offset++;
+                continue;
+            }
+            else if (peek(m_offset) == '}')
+            {
+                m_offset++;
+                handle(m_handler.on_object_end());
+                return;
+            }
+            else
+            {
+                m_error = bourne::error::parse_object_expected_comma;
+                return;
+            }
+        }
+    }
+
+    void parse_array()
+    {
+        assert(!m_error);
+        m_offset++;
+        handle(m_handler.on_array_begin());
+        if (m_error)
+            return;
+        reserve();
+
+        consume_white_space();
+        if (peek(m_offset) == ']')
+        {
+            m_offset++;
+            handle(m_handler.on_array_end());
+            return;
+        }
+
+        while (true)
+        {
+            parse_next();
+            if (m_error)
+                return;
+            consume_white_space();
+
+            if (peek(m_offset) == ',')
+            {
+                m_offset++;
+                continue;
+            }
+            else if (peek(m_offset) == ']')
+            {
+                m_offset++;
+                handle(m_handler.on_array_end());
+                return;
+            }
+            else
+            {
+                m_error = bourne::error::
+                    parse_array_expected_comma_or_closing_bracket;
+                return;
+            }
+        }
+    }
+
+    void parse_string(bool is_key)
+    {
+        assert(!m_error);
+        const std::size_t start = ++m_offset;
+
+        // Find the run of bytes up to the next quote or backslash
+        if (m_offset < m_input.size())
+        {
+            m_offset += find_quote_or_backslash(m_input.data() + m_offset,
+                                                m_input.size() - m_offset);
+        }
+
+        // Without escapes the string is passed directly from the input
+        if (m_offset < m_input.size() && m_input[m_offset] == '\"')
+        {
+            m_offset++;
+            emit_string(std::string_view(m_input.data() + start,
+                                         m_offset - start - 1),
+                        is_key);
+            return;
+        }
+
+        m_scratch.assign(m_input.data() + start, m_offset - start);
+        while (true)
+        {
+            if (m_offset >= m_input.size())
+            {
+                m_error = bourne::error::parse_string_expected_closing_quote;
+                return;
+            }
+
+            if (peek(m_offset) == '\"')
+                break;
+
+            assert(peek(m_offset) == '\\');
+            switch (peek(++m_offset))
+            {
+            case '\"':
+                m_scratch += '\"';
+                break;
+            case '\\':
+                m_scratch += '\\';
+                break;
+            case '/':
+                m_scratch += '/';
+                break;
+            case 'b':
+                m_scratch += '\b';
+                break;
+            case 'f':
+                m_scratch += '\f';
+                break;
+            case 'n':
+                m_scratch += '\n';
+                break;
+            case 'r':
+                m_scratch += '\r';
+                break;
+            case 't':
+                m_scratch += '\t';
+                break;
+            case 'u':
+            {
+                m_scratch += "\\u";
+                for (std::size_t i = 1; i <= 4; ++i)
+                {
+                    char c = peek(m_offset + i);
+                    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+                        (c >= 'A' && c <= 'F'))
+                    {
+                        m_scratch += c;
+                    }
+                    else
+                    {
+                        m_error = bourne::error::
+                            parse_string_expected_unicode_escape_hex_char;
+                        return;
+                    }
+                }
+                m_offset += 4;
+                break;
+            }
+            default:
+                m_scratch += '\\';
+                break;
+            }
+            m_offset++;
+
+            // Copy everything up to the next quote or backslash in one go
+            if (m_offset < m_input.size())
+            {
+                auto run = find_quote_or_backslash(m_input.data() + m_offset,
+                                                   m_input.size() - m_offset);
+                m_scratch.append(m_input.data() + m_offset, run);
+                m_offset += run;
+            }
+        }
+        m_offset++;
+        emit_string(m_scratch, is_key);
+    }
+
+    void emit_string(std::string_view value, bool is_key)
+    {
+        if (is_key)
+        {
+            handle(m_handler.on_key(value));
+        }
+        else
+        {
+            handle(m_handler.on_string(value));
+        }
+    }
+
+    void parse_number()
+    {
+        assert(!m_error);
+        decimal_number number{};
+        const std::size_t start = m_offset;
+        number.negative = peek(m_offset) == '-';
+        if (number.negative)
+            m_offset++;
+
+        // The integer part is a single zero or digits not starting with zero
+        if (!is_digit(peek(m_offset)))
+        {
+            m_error = bourne::error::parse_number_expected_number_for_component;
+            return;
+        }
+        if (peek(m_offset) == '0')
+        {
+            m_offset++;
+        }
+        else
+        {
+            parse_digits(number);
+        }
+
+        bool is_floating = false;
+        if (peek(m_offset) == '.')
+        {
+            is_floating = true;
+            m_offset++;
+            if (!is_digit(peek(m_offset)))
+            {
+                m_error =
+                    bourne::error::parse_number_expected_number_for_component;
+                return;
+            }
+            number.exponent -= parse_digits(number);
+        }
+
+        char c = peek(m_offset);
+        if (c == 'e' || c == 'E')
+        {
+            is_floating = true;
+            c = peek(++m_offset);
+            bool negative_exponent = c == '-';
+            if (c == '-' || c == '+')
+                m_offset++;
+            if (!is_digit(peek(m_offset)))
+            {
+                m_error =
+                    bourne::error::parse_number_expected_number_for_component;
+                return;
+            }
+
+            // Larger exponents over- or underflow a double anyway, the limit
+            // keeps the sum from overflowing.
+            int64_t exponent = 0;
+            while (is_digit(peek(m_offset)))
+            {
+                if (exponent < 100000)
+                    exponent = exponent * 10 + (peek(m_offset) - '0');
+                m_offset++;
+            }
+            number.exponent += negative_exponent ? -exponent : exponent;
+        }
+
+        if (m_offset < m_input.size())
+        {
+            c = m_input[m_offset];
+            if (!is_white_space(c) && c != ',' && c != ']' && c != '}')
+            {
+                m_error = bourne::error::parse_number_unexpected_char;
+                return;
+            }
+        }
+        number.text = m_input.substr(start, m_offset - start);
+
+        // Integers are only stored as doubles when they do not fit in an
+        // int64_t
+        if (!is_floating && number.digits <= max_exact_digits)
+        {
+            const uint64_t limit = uint64_t(INT64_MAX) + number.negative;
+            if (number.mantissa <= limit)
+            {
+                handle(m_handler.on_int(
+                    number.negative ? int64_t(0 - number.mantissa)
+                                    : int64_t(number.mantissa)));
+                return;
+            }
+        }
+
+        double value;
+        if (!to_double(number, value))
+        {
+            m_error = bourne::error::parse_number_out_of_range;
+            return;
+        }
+        handle(m_handler.on_double(value));
+    }
+
+    /// Adds a run of digits to the mantissa of the number.
+    /// @return The number of digits
+    std::size_t parse_digits(decimal_number& number)
+    {
+        const std::size_t start = m_offset;
+        while (is_digit(peek(m_offset)))
+        {
+            uint64_t digit = peek(m_offset) - '0';
+            if (number.digits != 0 || digit != 0)
+            {
+                // The mantissa wraps after max_exact_digits, in which case
+                // the text of the number is converted instead.
+                number.mantissa = number.mantissa * 10 + digit;
+                number.digits++;
+            }
+            m_offset++;
+        }
+        return m_offset - start;
+    }
+
+    void parse_bool()
+    {
+        assert(!m_error);
+        // Views of the input are compared without copying them
+        if (m_input.substr(m_offset, 4) == "true")
+        {
+            m_offset += 4;
+            handle(m_handler.on_bool(true));
+        }
+        else if (m_input.substr(m_offset, 5) == "false")
+        {
+            m_offset += 5;
+            handle(m_handler.on_bool(false));
+        }
+        else
+        {
+            m_error = bourne::error::parse_boolean_expected_true_or_false;
+        }
+    }
+
+    void parse_null()
+    {
+        assert(!m_error);
+        if (m_input.substr(m_offset, 4) != "null")
+        {
+            m_error = bourne::error::parse_null_expected_null;
+            return;
+        }
+        m_offset += 4;
+        handle(m_handler.on_null());
+    }
+
+    void parse_next()
+    {
+        assert(!m_error);
+        char value;
+        consume_white_space();
+        value = peek(m_offset);
+        switch (value)
+        {
+        case '[':
+            parse_array();
+            return;
+        case '{':
+            parse_object();
+            return;
+        case '\"':
+            parse_string(false);
+            return;
+        case 't':
+        case 'f':
+            parse_bool();
+            return;
+        case 'n':
+            parse_null();
+            return;
+        default:
+        {
+            if ((value <= '9' && value >= '0') || value == '-')
+            {
+                parse_number();
+                return;
+            }
+        }
+        }
+        m_error = bourne::error::parse_next_unexpected_char;
+    }
+
+private:
+    std::string_view m_input;
+    Handler& m_handler;
+    std::error_code& m_error;
+    std::size_t m_offset = 0;
+
+    /// The structural index used by the two-stage parser, nullptr when
+    /// parsing in a single stage.
+    const structural_index* m_index;
+
+    /// The next entry of the structural index to consider
+    std::size_t m_index_position = 0;
+
+    /// The next entry of the container sizes of the structural index
+    std::size_t m_container_position = 0;
+
+    /// Buffer for unescaping strings, reused between strings
+    std::string m_scratch;
+};
+}
+}
+}
@@ -0,0 +1,129 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Appends the lowest bytes of the value in big endian byte order, which
+/// both CBOR and MessagePack use
+inline void write_big_endian(uint64_t value, std::size_t bytes,
+                             std::vector<uint8_t>& output)
+{
+    assert(bytes <= 8);
+    uint8_t buffer[8];
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        buffer[i] = uint8_t(value >> (8 * (bytes - 1 - i)));
+    }
+    output.insert(output.end(), buffer, buffer + bytes);
+}
+
+/// @return The big endian value of the given number of bytes
+inline uint64_t read_big_endian(const uint8_t* data, std::size_t bytes)
+{
+    assert(bytes <= 8);
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+/// Stores the lowest bytes of the value in little endian byte order, which
+/// the binary tape uses
+inline void write_little_endian(uint64_t value, std::size_t bytes,
+                                uint8_t* output)
+{
+    assert(bytes <= 8);
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        output[i] = uint8_t(value >> (8 * i));
+    }
+}
+
+/// @return The little endian value of the given number of bytes
+inline uint64_t read_little_endian(const uint8_t* data, std::size_t bytes)
+{
+    assert(bytes <= 8);
+    uint64_t value = 0;
+    for (std::size_t i = bytes; i > 0; --i)
+    {
+        value = (value << 8) | data[i - 1];
+    }
+    return value;
+}
+
+/// @return True if the value is stored exactly as a single precision float
+inline bool is_exact_float(double value)
+{
+    return double(float(value)) == value || std::isnan(value);
+}
+
+inline uint64_t double_bits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bits_double(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint32_t float_bits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// @return The value of an IEEE 754 half precision float
+inline double half_to_double(uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0)
+    {
+        value = std::ldexp(mantissa, -24);
+    }
+    else if (exponent != 31)
+    {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    }
+    else
+    {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+}
+}
+}
@@ -0,0 +1,127 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../error.hpp"
+#include "basic_parser.hpp"
+#include "binary.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The input and error handling shared by the readers of the binary
+/// formats. Like basic_parser the readers report the values they decode to
+/// a handler instead of building json values.
+template <class Handler>
+class binary_reader
+{
+public:
+    binary_reader(const uint8_t* data, std::size_t size, Handler& handler,
+                  std::error_code& error) :
+        m_data(data), m_size(size), m_handler(handler), m_error(error)
+    {
+    }
+
+protected:
+    /// Stops reading if a handler callback returned false, unless the
+    /// handler already reported an error itself.
+    void handle(bool keep_going)
+    {
+        if (!keep_going && !m_error)
+            m_error = bourne::error::parse_stopped_by_handler;
+    }
+
+    /// @return True if the given number of bytes follow the offset,
+    ///         otherwise the error is set
+    bool available(uint64_t bytes)
+    {
+        if (bytes > m_size - m_offset)
+        {
+            m_error = bourne::error::decode_unexpected_end;
+            return false;
+        }
+        return true;
+    }
+
+    /// @return The next byte, which must be available
+    uint8_t next_byte()
+    {
+        assert(m_offset < m_size);
+        return m_data[m_offset++];
+    }
+
+    /// Reads a big endian number of the given number of bytes
+    bool read_number(std::size_t bytes, uint64_t& value)
+    {
+        if (!available(bytes))
+            return false;
+        value = read_big_endian(m_data + m_offset, bytes);
+        m_offset += bytes;
+        return true;
+    }
+
+    /// Reads a string of the given size, which is passed as a view of the
+    /// input
+    bool read_string(uint64_t size, std::string_view& string)
+    {
+        if (!available(size))
+            return false;
+        string = std::string_view(
+            reinterpret_cast<const char*>(m_data + m_offset), size);
+        m_offset += size;
+        return true;
+    }
+
+    /// Reports an integer, which is reported as a floating point value if
+    /// it does not fit in an int64_t like the text parser does
+    void report_unsigned(uint64_t value)
+    {
+        if (value <= uint64_t(INT64_MAX))
+        {
+            handle(m_handler.on_int(int64_t(value)));
+        }
+        else
+        {
+            handle(m_handler.on_double(double(value)));
+        }
+    }
+
+    /// Passes the size of the container just begun to the handler. The
+    /// size is limited by the bytes left, since every element takes at
+    /// least one byte, so invalid sizes do not reserve huge amounts.
+    void reserve(uint64_t size)
+    {
+        if constexpr (has_reserve<Handler>::value)
+            m_handler.reserve(std::size_t(std::min(size, m_size - m_offset)));
+    }
+
+    /// Checks that the whole input has been read
+    void end_document()
+    {
+        if (!m_error && m_offset != m_size)
+            m_error = bourne::error::decode_trailing_bytes;
+    }
+
+protected:
+    const uint8_t* m_data;
+    uint64_t m_size;
+    uint64_t m_offset = 0;
+    Handler& m_handler;
+    std::error_code& m_error;
+};
+}
+}
+}
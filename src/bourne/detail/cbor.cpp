@@ -0,0 +1,120 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "cbor.hpp"
+#include "../class_type.hpp"
+#include "binary.hpp"
+
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// Writes the initial byte of a data item with the shortest encoding of
+/// its argument
+void write_head(uint8_t major, uint64_t argument, std::vector<uint8_t>& output)
+{
+    const uint8_t type = uint8_t(major << 5);
+    if (argument < 24)
+    {
+        output.push_back(type | uint8_t(argument));
+    }
+    else if (argument <= UINT8_MAX)
+    {
+        output.push_back(type | 24);
+        write_big_endian(argument, 1, output);
+    }
+    else if (argument <= UINT16_MAX)
+    {
+        output.push_back(type | 25);
+        write_big_endian(argument, 2, output);
+    }
+    else if (argument <= UINT32_MAX)
+    {
+        output.push_back(type | 26);
+        write_big_endian(argument, 4, output);
+    }
+    else
+    {
+        output.push_back(type | 27);
+        write_big_endian(argument, 8, output);
+    }
+}
+
+void write_text(std::string_view text, std::vector<uint8_t>& output)
+{
+    write_head(3, text.size(), output);
+    output.insert(output.end(), text.begin(), text.end());
+}
+}
+
+void write_cbor(const json& value, std::vector<uint8_t>& output)
+{
+    switch (value.json_type())
+    {
+    case class_type::null:
+        output.push_back(0xf6);
+        return;
+    case class_type::boolean:
+        output.push_back(value.to_bool() ? 0xf5 : 0xf4);
+        return;
+    case class_type::integral:
+    {
+        // Negative integers are encoded as -1 minus the argument
+        const int64_t integer = value.to_int();
+        if (integer >= 0)
+        {
+            write_head(0, uint64_t(integer), output);
+        }
+        else
+        {
+            write_head(1, uint64_t(-1 - integer), output);
+        }
+        return;
+    }
+    case class_type::floating:
+    {
+        const double floating = value.to_float();
+        if (is_exact_float(floating))
+        {
+            output.push_back(0xfa);
+            write_big_endian(float_bits(float(floating)), 4, output);
+        }
+        else
+        {
+            output.push_back(0xfb);
+            write_big_endian(double_bits(floating), 8, output);
+        }
+        return;
+    }
+    case class_type::string:
+        write_text(value.to_string_view(), output);
+        return;
+    case class_type::array:
+        write_head(4, value.size(), output);
+        for (const auto& element : value.array_range())
+        {
+            write_cbor(element, output);
+        }
+        return;
+    case class_type::object:
+        write_head(5, value.size(), output);
+        for (const auto& member : value.object_range())
+        {
+            write_text(member.first.view(), output);
+            write_cbor(member.second, output);
+        }
+        return;
+    }
+    assert(0 && "Unknown class_type");
+}
+}
+}
+}
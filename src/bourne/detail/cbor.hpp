@@ -0,0 +1,294 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../error.hpp"
+#include "../json.hpp"
+#include "binary_reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Appends the value encoded as CBOR (RFC 8949). Integers use the shortest
+/// encoding, floating point values are written in single precision when it
+/// holds them exactly and in double precision otherwise.
+void write_cbor(const json& value, std::vector<uint8_t>& output);
+
+/// Reads a CBOR encoded value and reports it to a handler, with the same
+/// callbacks as basic_parser. Text strings are passed as views of the input.
+///
+/// Indefinite length strings, arrays and maps are supported. Byte strings,
+/// tags and simple values other than false, true and null have no json
+/// equivalent and are reported as bourne::error::decode_unsupported_type.
+template <class Handler>
+class cbor_reader : public binary_reader<Handler>
+{
+public:
+    using binary_reader<Handler>::binary_reader;
+
+    /// Reads a single value, which must span the whole input
+    void read_document()
+    {
+        read_value();
+        this->end_document();
+    }
+
+private:
+    /// The initial byte of a data item and its argument
+    struct head
+    {
+        uint8_t m_major;
+        uint8_t m_info;
+        uint64_t m_argument;
+    };
+
+    /// The additional information of indefinite lengths and of the break
+    /// ending them
+    static constexpr uint8_t indefinite = 31;
+
+    /// The byte ending indefinite length items
+    static constexpr uint8_t break_byte = 0xff;
+
+    bool read_head(head& head)
+    {
+        if (!this->available(1))
+            return false;
+        const uint8_t byte = this->next_byte();
+        head.m_major = byte >> 5;
+        head.m_info = byte & 0x1f;
+        head.m_argument = 0;
+
+        if (head.m_info < 24)
+        {
+            head.m_argument = head.m_info;
+            return true;
+        }
+        if (head.m_info <= 27)
+            return this->read_number(1U << (head.m_info - 24), head.m_argument);
+        if (head.m_info == indefinite && head.m_major >= 2 &&
+            head.m_major != 6)
+        {
+            return true;
+        }
+        this->m_error = bourne::error::decode_unsupported_type;
+        return false;
+    }
+
+    void read_value()
+    {
+        head head;
+        if (!read_head(head))
+            return;
+
+        switch (head.m_major)
+        {
+        case 0:
+            this->report_unsigned(head.m_argument);
+            return;
+        case 1:
+            // The value is -1 minus the argument
+            if (head.m_argument <= uint64_t(INT64_MAX))
+            {
+                this->handle(
+                    this->m_handler.on_int(-1 - int64_t(head.m_argument)));
+            }
+            else
+            {
+                this->handle(
+                    this->m_handler.on_double(-1.0 - double(head.m_argument)));
+            }
+            return;
+        case 3:
+            read_text(head, false);
+            return;
+        case 4:
+            read_array(head);
+            return;
+        case 5:
+            read_map(head);
+            return;
+        case 7:
+            read_simple(head);
+            return;
+        default:
+            // Byte strings and tags
+            this->m_error = bourne::error::decode_unsupported_type;
+            return;
+        }
+    }
+
+    void read_text(const head& head, bool is_key)
+    {
+        std::string_view text;
+        if (head.m_info != indefinite)
+        {
+            if (!this->read_string(head.m_argument, text))
+                return;
+        }
+        else
+        {
+            // The chunks are definite length text strings
+            m_scratch.clear();
+            while (!at_break())
+            {
+                struct head chunk;
+                std::string_view part;
+                if (this->m_error || !read_head(chunk))
+                    return;
+                if (chunk.m_major != 3 || chunk.m_info == indefinite)
+                {
+                    this->m_error = bourne::error::decode_unsupported_type;
+                    return;
+                }
+                if (!this->read_string(chunk.m_argument, part))
+                    return;
+                m_scratch.append(part.data(), part.size());
+            }
+            if (this->m_error)
+                return;
+            text = m_scratch;
+        }
+
+        if (is_key)
+        {
+            this->handle(this->m_handler.on_key(text));
+        }
+        else
+        {
+            this->handle(this->m_handler.on_string(text));
+        }
+    }
+
+    void read_array(const head& head)
+    {
+        this->handle(this->m_handler.on_array_begin());
+        if (this->m_error)
+            return;
+
+        if (head.m_info != indefinite)
+        {
+            this->reserve(head.m_argument);
+            for (uint64_t i = 0; i < head.m_argument && !this->m_error; ++i)
+            {
+                read_value();
+            }
+        }
+        else
+        {
+            while (!this->m_error && !at_break())
+            {
+                read_value();
+            }
+        }
+        if (this->m_error)
+            return;
+        this->handle(this->m_handler.on_array_end());
+    }
+
+    void read_map(const head& head)
+    {
+        this->handle(this->m_handler.on_object_begin());
+        if (this->m_error)
+            return;
+
+        if (head.m_info != indefinite)
+        {
+            this->reserve(head.m_argument);
+            for (uint64_t i = 0; i < head.m_argument && !this->m_error; ++i)
+            {
+                read_member();
+            }
+        }
+        else
+        {
+            while (!this->m_error && !at_break())
+            {
+                read_member();
+            }
+        }
+        if (this->m_error)
+            return;
+        this->handle(this->m_handler.on_object_end());
+    }
+
+    void read_member()
+    {
+        head key;
+        if (!read_head(key))
+            return;
+        if (key.m_major != 3)
+        {
+            this->m_error = bourne::error::decode_key_not_string;
+            return;
+        }
+        read_text(key, true);
+        if (this->m_error)
+            return;
+        read_value();
+    }
+
+    void read_simple(const head& head)
+    {
+        switch (head.m_info)
+        {
+        case 20:
+            this->handle(this->m_handler.on_bool(false));
+            return;
+        case 21:
+            this->handle(this->m_handler.on_bool(true));
+            return;
+        case 22:
+            this->handle(this->m_handler.on_null());
+            return;
+        case 25:
+            this->handle(this->m_handler.on_double(
+                half_to_double(uint16_t(head.m_argument))));
+            return;
+        case 26:
+            this->handle(this->m_handler.on_double(
+                bits_float(uint32_t(head.m_argument))));
+            return;
+        case 27:
+            this->handle(
+                this->m_handler.on_double(bits_double(head.m_argument)));
+            return;
+        default:
+            // Undefined, other simple values and breaks outside of
+            // indefinite length items
+            this->m_error = bourne::error::decode_unsupported_type;
+            return;
+        }
+    }
+
+    /// @return True if the next byte ends an indefinite length item, in
+    ///         which case it is consumed. Sets the error at the end of the
+    ///         input.
+    bool at_break()
+    {
+        if (!this->available(1))
+            return false;
+        if (this->m_data[this->m_offset] != break_byte)
+            return false;
+        this->m_offset++;
+        return true;
+    }
+
+private:
+    /// Buffer for joining the chunks of indefinite length strings
+    std::string m_scratch;
+};
+}
+}
+}
@@ -0,0 +1,228 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "dom_builder.hpp"
+#include "../error.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// The number of members from which members inserted out of order are
+/// appended instead of inserted in place
+const std::size_t unsorted_threshold = 32;
+}
+
+dom_builder::dom_builder(const json::parse_options& options, arena* arena,
+                         std::string_view input, std::error_code& error) :
+    m_options(options), m_arena(arena), m_error(error),
+    m_input(options.borrow_strings ? input : std::string_view())
+{
+}
+
+bool dom_builder::on_null()
+{
+    next_value() = nullptr;
+    return end_value();
+}
+
+bool dom_builder::on_bool(bool value)
+{
+    next_value() = value;
+    return end_value();
+}
+
+bool dom_builder::on_int(int64_t value)
+{
+    next_value() = value;
+    return end_value();
+}
+
+bool dom_builder::on_double(double value)
+{
+    next_value() = value;
+    return end_value();
+}
+
+bool dom_builder::on_string(std::string_view value)
+{
+    if (can_borrow(value))
+    {
+        next_value().set_borrowed_string(value);
+    }
+    else
+    {
+        next_value().set_string(value, m_arena);
+    }
+    return end_value();
+}
+
+bool dom_builder::on_object_begin()
+{
+    json& object = next_value();
+    object = json(class_type::object, m_arena);
+    m_stack.push_back(
+        {object.internal().m_map, nullptr, 0, false, false, false});
+    return true;
+}
+
+bool dom_builder::on_key(std::string_view key)
+{
+    assert(!m_stack.empty());
+    frame& top = m_stack.back();
+    assert(top.m_object != nullptr);
+
+    auto& members = *top.m_object;
+    top.m_duplicate_key = false;
+
+    // When parsing strictly the members are always inserted in place, so
+    // duplicate keys are found as they are parsed, before any error after
+    // them
+    if (!top.m_unsorted && !m_options.strict &&
+        members.size() >= unsorted_threshold &&
+        std::prev(members.end())->first > key)
+    {
+        // Keys which the object already had are found while it is sorted
+        auto member = members.find(key);
+        if (member != members.end())
+        {
+            top.m_duplicate_key = true;
+            m_member = &member->second;
+            return true;
+        }
+
+        // Inserting out of order into many sorted members would move the
+        // members following it every time, so from here on the members are
+        // appended and sorted once the object ends.
+        top.m_unsorted = true;
+    }
+
+    if (top.m_unsorted)
+    {
+        m_member = &members.append(make_key(key));
+        return true;
+    }
+
+    auto member = members.try_emplace(make_key(key));
+    top.m_duplicate_key = !member.second;
+    m_member = &member.first->second;
+    return true;
+}
+
+bool dom_builder::on_object_end()
+{
+    assert(!m_stack.empty());
+    frame top = m_stack.back();
+    m_stack.pop_back();
+
+    // Objects are only unsorted when duplicate keys are allowed
+    if (top.m_unsorted)
+        top.m_object->sort();
+    return end_value();
+}
+
+bool dom_builder::on_array_begin()
+{
+    json& array = next_value();
+    array = json(class_type::array, m_arena);
+    m_stack.push_back({nullptr, array.internal().m_array, m_elements.size(),
+                       false, false, true});
+    return true;
+}
+
+bool dom_builder::on_array_end()
+{
+    assert(!m_stack.empty());
+    frame top = m_stack.back();
+    if (top.m_collecting)
+    {
+        auto first = m_elements.begin() + top.m_first;
+        top.m_array->reserve(m_elements.end() - first);
+        std::move(first, m_elements.end(), std::back_inserter(*top.m_array));
+        m_elements.erase(first, m_elements.end());
+    }
+    m_stack.pop_back();
+    return end_value();
+}
+
+void dom_builder::reserve(std::size_t size)
+{
+    assert(!m_stack.empty());
+    frame& top = m_stack.back();
+    if (top.m_object != nullptr)
+    {
+        top.m_object->reserve(size);
+        return;
+    }
+    top.m_collecting = false;
+    top.m_array->reserve(size);
+}
+
+json dom_builder::release()
+{
+    return std::move(m_root);
+}
+
+json& dom_builder::next_value()
+{
+    if (m_stack.empty())
+        return m_root;
+
+    const frame& top = m_stack.back();
+    if (top.m_collecting)
+        return m_elements.emplace_back();
+    if (top.m_array != nullptr)
+        return top.m_array->emplace_back();
+
+    assert(m_member != nullptr);
+    json& member = *m_member;
+    m_member = nullptr;
+    return member;
+}
+
+key dom_builder::make_key(std::string_view characters)
+{
+    if (can_borrow(characters))
+        return key::borrow(characters);
+    if (m_options.intern_keys)
+        return m_keys.intern(characters);
+    return key(characters);
+}
+
+bool dom_builder::can_borrow(std::string_view characters) const
+{
+    // Strings without escape sequences are passed as views of the input,
+    // others as views of the buffer they were decoded into.
+    std::less_equal<const char*> less_equal;
+    return !m_input.empty() && less_equal(m_input.data(), characters.data()) &&
+           less_equal(characters.data() + characters.size(),
+                      m_input.data() + m_input.size());
+}
+
+bool dom_builder::end_value()
+{
+    // Like the value itself, duplicate keys are only reported once the value
+    // has been parsed, so errors inside the value take precedence.
+    if (!m_stack.empty() && m_stack.back().m_duplicate_key && m_options.strict)
+    {
+        m_error = bourne::error::parse_object_duplicate_key;
+        return false;
+    }
+    return true;
+}
+}
+}
+}
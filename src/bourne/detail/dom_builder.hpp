@@ -0,0 +1,130 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../handler.hpp"
+#include "../json.hpp"
+#include "arena.hpp"
+#include "key.hpp"
+#include "key_table.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Parser handler which builds a json value from the parse events.
+/// Values are built in place in their parent object or array.
+///
+/// The class is final so the calls made by basic_parser<dom_builder> are not
+/// virtual.
+class dom_builder final : public handler
+{
+public:
+    /// @param arena The arena to allocate values from or nullptr to use the
+    ///        heap.
+    /// @param input The input which strings are borrowed from when the
+    ///        borrow_strings option is set, or empty if the input is not
+    ///        kept while the value is used.
+    /// @param error Set to bourne::error::parse_object_duplicate_key when
+    ///        parsing strictly and a duplicate key is found.
+    dom_builder(const json::parse_options& options, arena* arena,
+                std::string_view input, std::error_code& error);
+
+    bool on_null() override;
+    bool on_bool(bool value) override;
+    bool on_int(int64_t value) override;
+    bool on_double(double value) override;
+    bool on_string(std::string_view value) override;
+    bool on_object_begin() override;
+    bool on_key(std::string_view key) override;
+    bool on_object_end() override;
+    bool on_array_begin() override;
+    bool on_array_end() override;
+
+    /// Reserves storage for the elements of the array or members of the
+    /// object just begun. The elements of an array reserved are stored in
+    /// it directly instead of being collected until it ends.
+    void reserve(std::size_t size);
+
+    /// @return The value built, which is moved out of the builder
+    json release();
+
+private:
+    /// @return The value to store the next parsed value in
+    json& next_value();
+
+    /// Called when a value has been parsed completely
+    bool end_value();
+
+    /// @return The key with the given characters, borrowed or interned if
+    ///         enabled
+    key make_key(std::string_view characters);
+
+    /// @return True if the characters can be borrowed from the input, which
+    ///         is the case for strings without escape sequences
+    bool can_borrow(std::string_view characters) const;
+
+private:
+    /// The objects and arrays are referred to by their storage, which is
+    /// not moved while they are built, unlike the values holding them which
+    /// may be collected in m_elements.
+    struct frame
+    {
+        /// The object being built or nullptr
+        json::object_type* m_object;
+
+        /// The array being built or nullptr
+        json::array_type* m_array;
+
+        /// The index of the first element of the array in m_elements
+        std::size_t m_first;
+
+        /// Set if the member currently parsed has a key which the object
+        /// already had
+        bool m_duplicate_key;
+
+        /// Set once members have been appended to the object out of order,
+        /// in which case the object is sorted when it ends.
+        bool m_unsorted;
+
+        /// Set while the elements of the array are collected in m_elements,
+        /// as its size is not known in advance
+        bool m_collecting;
+    };
+
+    const json::parse_options& m_options;
+    arena* m_arena;
+    std::error_code& m_error;
+
+    /// The input strings are borrowed from, empty if they are not
+    std::string_view m_input;
+
+    json m_root;
+
+    /// The objects and arrays currently being built, innermost last
+    std::vector<frame> m_stack;
+
+    /// The elements of the arrays being collected, innermost last. The
+    /// elements of an array are moved into storage of its final size once
+    /// it ends, so parsing an array does not grow it repeatedly.
+    std::vector<json> m_elements;
+
+    /// The object member to store the next value in, set by on_key()
+    json* m_member = nullptr;
+
+    /// The keys seen, used when interning keys
+    key_table m_keys;
+};
+}
+}
+}
@@ -20,3 +20,16 @@ BOURNE_ERROR_TAG(parse_boolean_expected_true_or_false,
                  "Expected \"true\" or \"false\"")
 BOURNE_ERROR_TAG(parse_null_expected_null, "Expected \"null\"")
 BOURNE_ERROR_TAG(parse_next_unexpected_char, "Unknown starting character.")
+BOURNE_ERROR_TAG(parse_string_expected_closing_quote, "Expected closing quote")
+BOURNE_ERROR_TAG(parse_stopped_by_handler, "Parsing stopped by handler")
+BOURNE_ERROR_TAG(parse_number_out_of_range, "Number out of range")
+BOURNE_ERROR_TAG(parse_input_too_large, "Input too large to be indexed")
+BOURNE_ERROR_TAG(decode_unexpected_end, "Unexpected end of binary input")
+BOURNE_ERROR_TAG(decode_unsupported_type, "Binary type has no json equivalent")
+BOURNE_ERROR_TAG(decode_key_not_string, "Object key is not a string")
+BOURNE_ERROR_TAG(decode_trailing_bytes, "Bytes following the binary value")
+BOURNE_ERROR_TAG(decode_invalid_tape, "Invalid binary tape")
+BOURNE_ERROR_TAG(pointer_invalid_syntax, "Invalid JSON pointer")
+BOURNE_ERROR_TAG(pointer_not_found, "JSON pointer refers to no value")
+BOURNE_ERROR_TAG(path_invalid_syntax, "Invalid or unsupported JSONPath")
+BOURNE_ERROR_TAG(encode_too_large, "Value too large to be encoded")
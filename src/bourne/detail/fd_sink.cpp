@@ -0,0 +1,51 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "fd_sink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+fd_sink::fd_sink(int fd, std::error_code& error) : m_fd(fd), m_error(error)
+{
+}
+
+void fd_sink::write(const char* data, std::size_t size)
+{
+    while (size > 0 && !m_error)
+    {
+#if defined(_WIN32)
+        auto written = ::_write(
+            m_fd, data, (unsigned int)std::min<std::size_t>(size, INT_MAX));
+#else
+        auto written = ::write(m_fd, data, size);
+#endif
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            m_error = std::error_code(errno, std::generic_category());
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+}
+}
+}
@@ -0,0 +1,36 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstddef>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Serializer sink which writes to a file descriptor
+class fd_sink
+{
+public:
+    /// @param error Set if writing fails, after which nothing more is
+    ///        written
+    fd_sink(int fd, std::error_code& error);
+
+    /// Writes all of the data, retrying partial and interrupted writes
+    void write(const char* data, std::size_t size);
+
+private:
+    int m_fd;
+    std::error_code& m_error;
+};
+}
+}
+}
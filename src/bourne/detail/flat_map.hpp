@@ -0,0 +1,524 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Map from string keys to values, which keeps the members in blocks of
+/// contiguous storage and a vector of pointers to them sorted by key.
+/// Lookups are a binary search over a single block of memory and iteration
+/// visits the members in key order like a std::map.
+///
+/// Like in a std::map, members are never moved once inserted, so
+/// references to them stay valid while other members are inserted, as in
+/// map["a"] = map["b"]. The members replaced by sort() are only released
+/// with the map.
+///
+/// The key type must be constructible from and convertible to
+/// std::string_view.
+template <class Key, class T, class Allocator>
+class flat_map
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using allocator_type = Allocator;
+
+private:
+    using traits = std::allocator_traits<Allocator>;
+    using member_allocator = typename traits::template rebind_alloc<value_type>;
+    using member_traits = std::allocator_traits<member_allocator>;
+    using index_type =
+        std::vector<value_type*,
+                    typename traits::template rebind_alloc<value_type*>>;
+
+    /// Storage for members, which is never moved
+    struct block
+    {
+        value_type* m_data;
+        std::size_t m_capacity;
+        std::size_t m_size;
+    };
+
+    using block_list =
+        std::vector<block, typename traits::template rebind_alloc<block>>;
+
+    /// Random access iterator over the members in key order
+    template <class Value>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        basic_iterator() = default;
+
+        /// Iterators convert to const iterators
+        template <class Other, class = std::enable_if_t<
+                                   std::is_convertible_v<Other*, Value*>>>
+        basic_iterator(const basic_iterator<Other>& other) :
+            m_position(other.m_position)
+        {
+        }
+
+        reference operator*() const
+        {
+            return **m_position;
+        }
+
+        pointer operator->() const
+        {
+            return *m_position;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *m_position[n];
+        }
+
+        basic_iterator& operator++()
+        {
+            ++m_position;
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            return basic_iterator(m_position++);
+        }
+
+        basic_iterator& operator--()
+        {
+            --m_position;
+            return *this;
+        }
+
+        basic_iterator operator--(int)
+        {
+            return basic_iterator(m_position--);
+        }
+
+        basic_iterator& operator+=(difference_type n)
+        {
+            m_position += n;
+            return *this;
+        }
+
+        basic_iterator& operator-=(difference_type n)
+        {
+            m_position -= n;
+            return *this;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend basic_iterator operator+(difference_type n, basic_iterator it)
+        {
+            return it += n;
+        }
+
+        friend basic_iterator operator-(basic_iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const basic_iterator& a,
+                                         const basic_iterator& b)
+        {
+            return a.m_position - b.m_position;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position == b.m_position;
+        }
+
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position != b.m_position;
+        }
+
+        friend bool operator<(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position < b.m_position;
+        }
+
+        friend bool operator>(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position > b.m_position;
+        }
+
+        friend bool operator<=(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position <= b.m_position;
+        }
+
+        friend bool operator>=(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.m_position >= b.m_position;
+        }
+
+    private:
+        friend class flat_map;
+
+        template <class Other>
+        friend class basic_iterator;
+
+        using node_pointer = typename flat_map::value_type*;
+
+        explicit basic_iterator(const node_pointer* position) :
+            m_position(position)
+        {
+        }
+
+        const node_pointer* m_position = nullptr;
+    };
+
+public:
+    using iterator = basic_iterator<value_type>;
+    using const_iterator = basic_iterator<const value_type>;
+
+    flat_map() = default;
+
+    explicit flat_map(const allocator_type& allocator) :
+        m_members(allocator), m_blocks(allocator)
+    {
+    }
+
+    /// Copies the members using the allocator which the allocator of
+    /// other selects for copies
+    flat_map(const flat_map& other) :
+        m_members(traits::select_on_container_copy_construction(
+            other.get_allocator())),
+        m_blocks(m_members.get_allocator())
+    {
+        try
+        {
+            reserve(other.size());
+            for (const value_type* member : other.m_members)
+                m_members.push_back(create(*member));
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    flat_map(flat_map&& other) noexcept :
+        m_members(std::move(other.m_members)),
+        m_blocks(std::move(other.m_blocks)), m_free(other.m_free)
+    {
+        other.m_members.clear();
+        other.m_blocks.clear();
+        other.m_free = 0;
+    }
+
+    flat_map& operator=(const flat_map&) = delete;
+    flat_map& operator=(flat_map&&) = delete;
+
+    ~flat_map()
+    {
+        release();
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(m_members.get_allocator());
+    }
+
+    iterator begin()
+    {
+        return iterator(m_members.data());
+    }
+
+    iterator end()
+    {
+        return iterator(m_members.data() + m_members.size());
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(m_members.data());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(m_members.data() + m_members.size());
+    }
+
+    std::size_t size() const
+    {
+        return m_members.size();
+    }
+
+    bool empty() const
+    {
+        return m_members.empty();
+    }
+
+    std::size_t capacity() const
+    {
+        return std::min(m_members.capacity(), m_members.size() + m_free);
+    }
+
+    /// Reserves storage for size members, so inserting them allocates no
+    /// more memory
+    void reserve(std::size_t size)
+    {
+        m_members.reserve(size);
+        if (size > m_members.size() + m_free)
+            add_block(size - m_members.size());
+    }
+
+    /// Releases the unused capacity of the sorted pointers. The storage of
+    /// the members is kept, as they are never moved.
+    void shrink_to_fit()
+    {
+        m_members.shrink_to_fit();
+    }
+
+    /// @return The member with the key or end() if there is none
+    iterator find(std::string_view key)
+    {
+        return begin() + (find_const(key) - std::as_const(*this).begin());
+    }
+
+    /// @return The member with the key or end() if there is none
+    const_iterator find(std::string_view key) const
+    {
+        return find_const(key);
+    }
+
+    /// @return The value of the key, throws std::out_of_range if there is
+    ///         none.
+    T& at(std::string_view key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("flat_map::at");
+        return it->second;
+    }
+
+    /// @return The value of the key, throws std::out_of_range if there is
+    ///         none.
+    const T& at(std::string_view key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("flat_map::at");
+        return it->second;
+    }
+
+    /// @return The value of the key, which is inserted if there is none
+    T& operator[](std::string_view key)
+    {
+        return try_emplace(Key(key)).first->second;
+    }
+
+    /// Inserts a default constructed value for the key if there is none.
+    /// @return The member with the key and true if it was inserted
+    std::pair<iterator, bool> try_emplace(Key&& key)
+    {
+        // Members are often inserted in order, so check the end first
+        auto position = m_members.end();
+        if (!m_members.empty() && !less(m_members.back()->first, key))
+        {
+            position = lower_bound(key);
+            if (equal((*position)->first, key))
+                return {begin() + (position - m_members.begin()), false};
+        }
+        return {insert(position, std::move(key)), true};
+    }
+
+    /// Appends a member without keeping the members sorted or checking for
+    /// duplicate keys, which is faster than try_emplace() when inserting
+    /// many members out of order. sort() must be called before the map is
+    /// used otherwise.
+    /// @return The value of the member appended
+    T& append(Key&& key)
+    {
+        return insert(m_members.end(), std::move(key))->second;
+    }
+
+    /// Sorts the members after append(). Of the members with the same key
+    /// only the last one appended is kept.
+    /// @return True if any members with duplicate keys were removed
+    bool sort()
+    {
+        std::stable_sort(m_members.begin(), m_members.end(),
+                         [](const value_type* a, const value_type* b)
+                         { return less(a->first, b->first); });
+
+        // Keep the last of each run of equal keys
+        auto out = m_members.begin();
+        for (auto it = m_members.begin(); it != m_members.end(); ++out)
+        {
+            auto last = it;
+            while (++it != m_members.end() &&
+                   !less((*last)->first, (*it)->first))
+            {
+                last = it;
+            }
+            *out = *last;
+        }
+        bool duplicates = out != m_members.end();
+        m_members.erase(out, m_members.end());
+        return duplicates;
+    }
+
+private:
+    const_iterator find_const(std::string_view key) const
+    {
+        // Comparing small objects for equality is cheaper than a binary
+        // search, since most keys differ in length or first bytes.
+        if (m_members.size() <= linear_search_size)
+        {
+            return std::find_if(begin(), end(),
+                                [key](const value_type& member)
+                                { return equal(member.first, key); });
+        }
+
+        auto position = lower_bound(key);
+        if (position == m_members.end() || !equal((*position)->first, key))
+            return end();
+        return begin() + (position - m_members.begin());
+    }
+
+    typename index_type::const_iterator lower_bound(std::string_view key) const
+    {
+        return std::lower_bound(m_members.begin(), m_members.end(), key,
+                                [](const value_type* member, std::string_view k)
+                                { return less(member->first, k); });
+    }
+
+    typename index_type::iterator lower_bound(std::string_view key)
+    {
+        return m_members.begin() +
+               (std::as_const(*this).lower_bound(key) - m_members.cbegin());
+    }
+
+    /// Inserts a member with the key and a default constructed value before
+    /// the position
+    /// @return The member inserted
+    iterator insert(typename index_type::iterator position, Key&& key)
+    {
+        const std::size_t offset = position - m_members.begin();
+        if (m_members.capacity() == 0)
+            reserve(initial_capacity);
+        else if (m_members.size() == m_members.capacity())
+            m_members.reserve(m_members.size() * 2);
+
+        // The pointers do not grow below, so inserting the member cannot
+        // fail once it has been created
+        value_type* member = create(std::move(key), T());
+        m_members.insert(m_members.begin() + offset, member);
+        return begin() + offset;
+    }
+
+    /// Constructs a member in the storage of the last block
+    template <class... Args>
+    value_type* create(Args&&... args)
+    {
+        if (m_free == 0)
+            add_block(std::max(initial_capacity, m_members.size()));
+
+        block& last = m_blocks.back();
+        member_allocator allocator(m_members.get_allocator());
+        value_type* member = last.m_data + last.m_size;
+        member_traits::construct(allocator, member,
+                                 std::forward<Args>(args)...);
+        ++last.m_size;
+        --m_free;
+        return member;
+    }
+
+    /// Adds a block of storage for the given number of members
+    void add_block(std::size_t capacity)
+    {
+        member_allocator allocator(m_members.get_allocator());
+        m_blocks.reserve(m_blocks.size() + 1);
+        value_type* data = member_traits::allocate(allocator, capacity);
+        m_blocks.push_back({data, capacity, 0});
+        m_free = capacity;
+    }
+
+    /// Destroys the members and releases their storage
+    void release()
+    {
+        member_allocator allocator(m_members.get_allocator());
+        for (block& block : m_blocks)
+        {
+            for (std::size_t i = 0; i < block.m_size; ++i)
+                member_traits::destroy(allocator, block.m_data + i);
+            member_traits::deallocate(allocator, block.m_data,
+                                      block.m_capacity);
+        }
+        m_blocks.clear();
+        m_members.clear();
+        m_free = 0;
+    }
+
+    /// Keys which refer to the same characters, like the copies of an
+    /// interned key, are compared without reading the characters
+    static bool equal(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() &&
+               (a.data() == b.data() || a.compare(b) == 0);
+    }
+
+    static bool less(std::string_view a, std::string_view b)
+    {
+        if (a.data() == b.data() && a.size() == b.size())
+            return false;
+        return a < b;
+    }
+
+private:
+    /// The number of members up to which lookups search linearly
+    static constexpr std::size_t linear_search_size = 8;
+
+    /// The capacity reserved by the first insertion, which avoids growing
+    /// the members one at a time for small objects
+    static constexpr std::size_t initial_capacity = 4;
+
+    /// Pointers to the members, sorted by key
+    index_type m_members;
+
+    /// The storage of the members, in the order they were created
+    block_list m_blocks;
+
+    /// The number of members which fit in the last block
+    std::size_t m_free = 0;
+};
+}
+}
+}
@@ -0,0 +1,107 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "key.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+key::key(std::string_view string)
+{
+    if (string.size() <= inline_capacity)
+    {
+        m_data.m_inline.m_size = uint8_t(string.size());
+        std::memcpy(m_data.m_inline.m_data, string.data(), string.size());
+        return;
+    }
+
+    void* memory = ::operator new(sizeof(buffer) + string.size());
+    buffer* shared_buffer = new (memory) buffer{{1}, string.size()};
+    std::memcpy(shared_buffer->data(), string.data(), string.size());
+    m_data.m_shared = shared_data{shared, shared_buffer};
+}
+
+key::key(const key& other) : m_data(other.m_data)
+{
+    if (other.is_borrowed())
+    {
+        *this = key(other.view());
+        return;
+    }
+
+    if (is_shared())
+    {
+        m_data.m_shared.m_buffer->m_references.fetch_add(
+            1, std::memory_order_relaxed);
+    }
+}
+
+key::key(key&& other) noexcept : m_data(other.m_data)
+{
+    other.m_data.m_inline = inline_data{0, {}};
+}
+
+key& key::operator=(const key& other)
+{
+    if (this != &other)
+    {
+        key copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+key& key::operator=(key&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_data = other.m_data;
+        other.m_data.m_inline = inline_data{0, {}};
+    }
+    return *this;
+}
+
+key::~key()
+{
+    release();
+}
+
+key key::borrow(std::string_view string)
+{
+    // Sizes which do not fit the borrowed layout are copied instead
+    if (string.size() <= inline_capacity || string.size() > UINT32_MAX)
+        return key(string);
+
+    key result;
+    result.m_data.m_borrowed =
+        borrowed_data{borrowed, uint32_t(string.size()), string.data()};
+    return result;
+}
+
+void key::release()
+{
+    if (!is_shared())
+        return;
+
+    buffer* shared_buffer = m_data.m_shared.m_buffer;
+    if (shared_buffer->m_references.fetch_sub(1, std::memory_order_acq_rel) ==
+        1)
+    {
+        shared_buffer->~buffer();
+        ::operator delete(shared_buffer);
+    }
+    m_data.m_inline = inline_data{0, {}};
+}
+}
+}
+}
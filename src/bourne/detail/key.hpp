@@ -0,0 +1,276 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The key of an object member. Keys of up to inline_capacity bytes are
+/// stored in the key itself. Longer keys are stored in an immutable,
+/// reference counted buffer which copies of the key share, so equal keys
+/// interned by a key_table share one buffer, or refer to characters owned
+/// by someone else when created with borrow().
+///
+/// A key converts to std::string_view and std::string, compares equal to
+/// strings with the same characters and has the read only interface of a
+/// std::string, so code using the keys of an object as strings keeps
+/// working.
+class key
+{
+public:
+    /// The largest key stored in the key itself
+    static constexpr std::size_t inline_capacity = 15;
+
+    /// Creates an empty key
+    key() = default;
+
+    /// Creates a key with a copy of the characters
+    explicit key(std::string_view string);
+
+    /// Copies of borrowed keys own their characters
+    key(const key& other);
+
+    key(key&& other) noexcept;
+
+    key& operator=(const key& other);
+
+    key& operator=(key&& other) noexcept;
+
+    ~key();
+
+    /// @return A key referring to the characters, which must outlive the
+    ///         key and its moves. Short keys are still stored inline.
+    static key borrow(std::string_view string);
+
+    /// @return The characters of the key
+    std::string_view view() const
+    {
+        if (is_shared())
+        {
+            return std::string_view(m_data.m_shared.m_buffer->data(),
+                                    m_data.m_shared.m_buffer->m_size);
+        }
+        if (is_borrowed())
+        {
+            return std::string_view(m_data.m_borrowed.m_data,
+                                    m_data.m_borrowed.m_length);
+        }
+        return std::string_view(m_data.m_inline.m_data,
+                                m_data.m_inline.m_size);
+    }
+
+    operator std::string_view() const
+    {
+        return view();
+    }
+
+    operator std::string() const
+    {
+        return std::string(view());
+    }
+
+    std::size_t size() const
+    {
+        return view().size();
+    }
+
+    std::size_t length() const
+    {
+        return size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const char* data() const
+    {
+        return view().data();
+    }
+
+    std::string_view::const_iterator begin() const
+    {
+        return view().begin();
+    }
+
+    std::string_view::const_iterator end() const
+    {
+        return view().end();
+    }
+
+    char operator[](std::size_t position) const
+    {
+        return view()[position];
+    }
+
+    int compare(std::string_view other) const
+    {
+        return view().compare(other);
+    }
+
+    /// @return The substring like std::string::substr(), which refers to the
+    ///         characters of the key
+    std::string_view substr(std::size_t position,
+                            std::size_t count = std::string_view::npos) const
+    {
+        return view().substr(position, count);
+    }
+
+    std::size_t find(std::string_view string, std::size_t position = 0) const
+    {
+        return view().find(string, position);
+    }
+
+    /// @return True if the other key shares the buffer of this key
+    bool shares_buffer(const key& other) const
+    {
+        return is_shared() && other.is_shared() &&
+               m_data.m_shared.m_buffer == other.m_data.m_shared.m_buffer;
+    }
+
+    bool operator==(const key& other) const
+    {
+        // Keys sharing a buffer are equal without comparing characters
+        return shares_buffer(other) || view() == other.view();
+    }
+
+    bool operator!=(const key& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const key& other) const
+    {
+        return !shares_buffer(other) && view() < other.view();
+    }
+
+private:
+    /// A buffer shared by the copies of a long key, followed by the
+    /// characters of the key
+    struct buffer
+    {
+        std::atomic<uint32_t> m_references;
+        std::size_t m_size;
+
+        char* data()
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    /// The size of keys which use a shared buffer
+    static constexpr uint8_t shared = 0xff;
+
+    /// The size of keys which refer to characters they do not own
+    static constexpr uint8_t borrowed = 0xfe;
+
+    struct inline_data
+    {
+        uint8_t m_size;
+        char m_data[inline_capacity];
+    };
+
+    struct shared_data
+    {
+        /// Always shared
+        uint8_t m_size;
+        buffer* m_buffer;
+    };
+
+    struct borrowed_data
+    {
+        /// Always borrowed
+        uint8_t m_size;
+        uint32_t m_length;
+        const char* m_data;
+    };
+
+    /// The layouts start with the size, which can therefore be read through
+    /// m_inline whichever layout is in use.
+    union storage
+    {
+        inline_data m_inline;
+        shared_data m_shared;
+        borrowed_data m_borrowed;
+    };
+
+    bool is_shared() const
+    {
+        return m_data.m_inline.m_size == shared;
+    }
+
+    bool is_borrowed() const
+    {
+        return m_data.m_inline.m_size == borrowed;
+    }
+
+    /// Releases the reference to the buffer of a shared key
+    void release();
+
+private:
+    storage m_data = {inline_data{0, {}}};
+};
+
+inline bool operator==(const key& a, std::string_view b)
+{
+    return a.view() == b;
+}
+
+inline bool operator==(std::string_view a, const key& b)
+{
+    return a == b.view();
+}
+
+inline bool operator!=(const key& a, std::string_view b)
+{
+    return a.view() != b;
+}
+
+inline bool operator!=(std::string_view a, const key& b)
+{
+    return a != b.view();
+}
+
+inline bool operator<(const key& a, std::string_view b)
+{
+    return a.view() < b;
+}
+
+inline bool operator<(std::string_view a, const key& b)
+{
+    return a < b.view();
+}
+
+inline std::string operator+(const std::string& a, const key& b)
+{
+    return a + std::string(b.view());
+}
+
+inline std::string operator+(const key& a, const std::string& b)
+{
+    return std::string(a.view()) + b;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const key& key)
+{
+    return os << key.view();
+}
+}
+}
+}
@@ -0,0 +1,32 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "key_table.hpp"
+
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+key key_table::intern(std::string_view string)
+{
+    // Inline keys have nothing to share
+    if (string.size() <= key::inline_capacity)
+        return key(string);
+
+    auto it = m_keys.find(string);
+    if (it != m_keys.end())
+        return it->second;
+
+    key interned(string);
+    m_keys.emplace(interned.view(), interned);
+    return interned;
+}
+}
+}
+}
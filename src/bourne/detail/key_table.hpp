@@ -0,0 +1,35 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "key.hpp"
+
+#include <string_view>
+#include <unordered_map>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Table of the keys seen while parsing a document. Equal keys which are
+/// too long to be stored inline share one buffer, so arrays of objects with
+/// the same keys store each key once.
+class key_table
+{
+public:
+    /// @return A key with the characters of the string, sharing the buffer
+    ///         of an equal key returned before if it has one.
+    key intern(std::string_view string);
+
+private:
+    /// The keys interned, indexed by views of their own buffers
+    std::unordered_map<std::string_view, key> m_keys;
+};
+}
+}
+}
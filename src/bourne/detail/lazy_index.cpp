@@ -0,0 +1,158 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "lazy_index.hpp"
+#include "../error.hpp"
+#include "../handler.hpp"
+#include "basic_parser.hpp"
+#include "simd.hpp"
+
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// The input indexed when the real input is invalid
+const std::string_view null_input = "null";
+
+/// Handler which ignores all values, used to validate the input
+class validator final : public handler
+{
+};
+
+/// Handler which keeps the characters of a key
+class key_reader final : public handler
+{
+public:
+    bool on_key(std::string_view key) override
+    {
+        m_key = key;
+        return true;
+    }
+
+    std::string m_key;
+};
+
+std::string_view input_to_index(std::string_view input)
+{
+    return input.size() <= structural_index::max_size ? input : null_input;
+}
+}
+
+lazy_index::lazy_index(std::string_view input, std::error_code& error) :
+    m_input(input_to_index(input)), m_index(m_input.data(), m_input.size())
+{
+    assert(!error);
+    if (m_input.size() != input.size())
+    {
+        error = bourne::error::parse_input_too_large;
+    }
+    else
+    {
+        validator ignore;
+        basic_parser<validator>(m_input, ignore, error, &m_index)
+            .parse_document();
+    }
+
+    if (error)
+    {
+        m_input = null_input;
+        m_index = structural_index(m_input.data(), m_input.size());
+    }
+    match_brackets();
+}
+
+std::string_view lazy_index::text(uint32_t position) const
+{
+    const uint32_t start = offset(position);
+    const char c = first_byte(position);
+    if (c == '{' || c == '[')
+        return m_input.substr(start, offset(m_ends[position]) + 1 - start);
+
+    // Other values end before the white space preceding the next entry
+    uint32_t end = offset(position + 1);
+    while (end > start && is_white_space(m_input[end - 1]))
+    {
+        end--;
+    }
+    return m_input.substr(start, end - start);
+}
+
+bool lazy_index::key_equals(uint32_t member, std::string_view key) const
+{
+    // Keys without escape sequences are compared where they are
+    std::string_view raw = raw_key(member);
+    if (raw.find('\\') == std::string_view::npos)
+        return raw == key;
+    return this->key(member) == key;
+}
+
+std::string lazy_index::key(uint32_t member) const
+{
+    std::string_view raw = raw_key(member);
+    if (raw.find('\\') == std::string_view::npos)
+        return std::string(raw);
+
+    // The quotes are included, as the parser expects them
+    key_reader reader;
+    std::error_code error;
+    basic_parser<key_reader>(
+        std::string_view(raw.data() - 1, raw.size() + 2), reader, error,
+        nullptr)
+        .parse_key();
+    assert(!error && "The input has been validated");
+    return std::move(reader.m_key);
+}
+
+std::string_view lazy_index::raw_key(uint32_t member) const
+{
+    assert(first_byte(member) == '\"');
+
+    // The closing quote is the last byte before the colon, not counting
+    // white space
+    const uint32_t start = offset(member) + 1;
+    uint32_t end = offset(member + 1);
+    while (m_input[end - 1] != '\"')
+    {
+        end--;
+    }
+    return m_input.substr(start, end - 1 - start);
+}
+
+void lazy_index::match_brackets()
+{
+    const auto& offsets = m_index.offsets();
+    m_ends.assign(offsets.size(), 0);
+
+    // The positions of the objects and arrays not closed yet
+    std::vector<uint32_t> open;
+    for (uint32_t position = 0; position + 1 < offsets.size(); ++position)
+    {
+        switch (m_input[offsets[position]])
+        {
+        case '{':
+        case '[':
+            open.push_back(position);
+            break;
+        case '}':
+        case ']':
+            assert(!open.empty());
+            m_ends[open.back()] = position;
+            open.pop_back();
+            break;
+        default:
+            break;
+        }
+    }
+    assert(open.empty());
+}
+}
+}
+}
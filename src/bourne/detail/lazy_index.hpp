@@ -0,0 +1,127 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "structural_index.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The index of a validated json input which is navigated without parsing
+/// it. Values are identified by their position in the structural index,
+/// which is the entry of their first byte. Every object and array knows the
+/// position of its closing bracket, so the values which are not visited are
+/// skipped in one step.
+class lazy_index
+{
+public:
+    /// Validates and indexes the input, which must outlive the index.
+    /// @param error Set if the input is not valid json, in which case the
+    ///        index describes a null value.
+    lazy_index(std::string_view input, std::error_code& error);
+
+    /// @return The byte at the start of the value at the position
+    char first_byte(uint32_t position) const
+    {
+        return m_input[offset(position)];
+    }
+
+    /// @return The offset in the input of the entry at the position
+    uint32_t offset(uint32_t position) const
+    {
+        assert(position < m_index.offsets().size());
+        return m_index.offsets()[position];
+    }
+
+    /// @return The position following the value at the position
+    uint32_t skip(uint32_t position) const
+    {
+        const char c = first_byte(position);
+        if (c == '{' || c == '[')
+            return m_ends[position] + 1;
+        return position + 1;
+    }
+
+    /// @return The json text of the value at the position
+    std::string_view text(uint32_t position) const;
+
+    /// @return The position of the first member of the object at the
+    ///         position, which is the position of its key, or zero if the
+    ///         object is empty.
+    uint32_t first_member(uint32_t position) const
+    {
+        assert(first_byte(position) == '{');
+        return first_byte(position + 1) == '}' ? 0 : position + 1;
+    }
+
+    /// @return The position of the member following the member at the
+    ///         position, or zero if it is the last.
+    uint32_t next_member(uint32_t member) const
+    {
+        const uint32_t next = skip(member_value(member));
+        return first_byte(next) == ',' ? next + 1 : 0;
+    }
+
+    /// @return The position of the value of the member at the position
+    uint32_t member_value(uint32_t member) const
+    {
+        // The key is followed by the colon and then the value
+        return member + 2;
+    }
+
+    /// @return The position of the first element of the array at the
+    ///         position, or zero if the array is empty.
+    uint32_t first_element(uint32_t position) const
+    {
+        assert(first_byte(position) == '[');
+        return first_byte(position + 1) == ']' ? 0 : position + 1;
+    }
+
+    /// @return The position of the element following the element at the
+    ///         position, or zero if it is the last.
+    uint32_t next_element(uint32_t element) const
+    {
+        const uint32_t next = skip(element);
+        return first_byte(next) == ',' ? next + 1 : 0;
+    }
+
+    /// @return True if the key of the member at the position has the given
+    ///         characters
+    bool key_equals(uint32_t member, std::string_view key) const;
+
+    /// @return The characters of the key of the member at the position
+    std::string key(uint32_t member) const;
+
+private:
+    /// @return The text of the key at the position without the quotes and
+    ///         with escape sequences as they are in the input
+    std::string_view raw_key(uint32_t member) const;
+
+    /// Finds the closing bracket of every object and array
+    void match_brackets();
+
+private:
+    std::string_view m_input;
+    structural_index m_index;
+
+    /// For the positions of objects and arrays, the position of their
+    /// closing bracket
+    std::vector<uint32_t> m_ends;
+};
+}
+}
+}
@@ -0,0 +1,104 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "mapped_file.hpp"
+
+#include <cassert>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+#if defined(_WIN32)
+mapped_file::mapped_file(const std::string& path, std::error_code& error,
+                         access mode)
+{
+    assert(!error);
+    (void)mode;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        error = std::make_error_code(std::errc::no_such_file_or_directory);
+        return;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+mapped_file::~mapped_file()
+{
+}
+#else
+mapped_file::mapped_file(const std::string& path, std::error_code& error,
+                         access mode)
+{
+    assert(!error);
+    int fd;
+    do
+    {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd < 0)
+    {
+        error = std::error_code(errno, std::generic_category());
+        return;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        error = std::error_code(errno, std::generic_category());
+        ::close(fd);
+        return;
+    }
+
+    // Empty files cannot be mapped
+    if (status.st_size > 0)
+    {
+        void* data = ::mmap(nullptr, std::size_t(status.st_size), PROT_READ,
+                            MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            error = std::error_code(errno, std::generic_category());
+            ::close(fd);
+            return;
+        }
+
+        // The advice only affects performance, so failing is ignored
+        ::madvise(data, std::size_t(status.st_size),
+                  mode == access::sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        m_data = static_cast<const char*>(data);
+        m_size = std::size_t(status.st_size);
+    }
+
+    // The mapping stays valid without the file descriptor
+    ::close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+    if (m_data != nullptr)
+        ::munmap(const_cast<char*>(m_data), m_size);
+}
+#endif
+}
+}
+}
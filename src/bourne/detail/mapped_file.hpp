@@ -0,0 +1,65 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// A file mapped read-only into memory, so it can be parsed without reading
+/// it into a buffer first. The kernel is advised how the file is accessed,
+/// so it reads ahead and drops the pages already parsed when the file is
+/// read sequentially.
+///
+/// Platforms without mmap read the file into memory instead.
+class mapped_file
+{
+public:
+    /// How the contents of the file are accessed
+    enum class access
+    {
+        sequential,
+        random
+    };
+
+    /// @param error Set if the file cannot be opened or mapped, in which
+    ///        case data() is empty.
+    mapped_file(const std::string& path, std::error_code& error,
+                access mode = access::sequential);
+
+    /// Unmaps the file
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /// @return The contents of the file
+    std::string_view data() const
+    {
+        return std::string_view(m_data, m_size);
+    }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+
+#if defined(_WIN32)
+    /// The contents of the file read into memory
+    std::string m_buffer;
+#endif
+};
+}
+}
+}
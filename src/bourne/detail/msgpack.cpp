@@ -0,0 +1,169 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "msgpack.hpp"
+#include "../class_type.hpp"
+#include "binary.hpp"
+
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// Writes a type byte followed by the argument in the given number of bytes
+void write_typed(uint8_t type, uint64_t argument, std::size_t bytes,
+                 std::vector<uint8_t>& output)
+{
+    output.push_back(type);
+    write_big_endian(argument, bytes, output);
+}
+
+void write_integer(int64_t integer, std::vector<uint8_t>& output)
+{
+    if (integer >= 0)
+    {
+        const uint64_t value = uint64_t(integer);
+        if (value <= 0x7f)
+        {
+            output.push_back(uint8_t(value));
+        }
+        else if (value <= UINT8_MAX)
+        {
+            write_typed(0xcc, value, 1, output);
+        }
+        else if (value <= UINT16_MAX)
+        {
+            write_typed(0xcd, value, 2, output);
+        }
+        else if (value <= UINT32_MAX)
+        {
+            write_typed(0xce, value, 4, output);
+        }
+        else
+        {
+            write_typed(0xcf, value, 8, output);
+        }
+        return;
+    }
+
+    if (integer >= -32)
+    {
+        output.push_back(uint8_t(integer));
+    }
+    else if (integer >= INT8_MIN)
+    {
+        write_typed(0xd0, uint64_t(integer), 1, output);
+    }
+    else if (integer >= INT16_MIN)
+    {
+        write_typed(0xd1, uint64_t(integer), 2, output);
+    }
+    else if (integer >= INT32_MIN)
+    {
+        write_typed(0xd2, uint64_t(integer), 4, output);
+    }
+    else
+    {
+        write_typed(0xd3, uint64_t(integer), 8, output);
+    }
+}
+
+void write_text(std::string_view text, std::vector<uint8_t>& output)
+{
+    assert(text.size() <= UINT32_MAX && "MessagePack strings are limited");
+    if (text.size() < 32)
+    {
+        output.push_back(uint8_t(0xa0 | text.size()));
+    }
+    else if (text.size() <= UINT8_MAX)
+    {
+        write_typed(0xd9, text.size(), 1, output);
+    }
+    else if (text.size() <= UINT16_MAX)
+    {
+        write_typed(0xda, text.size(), 2, output);
+    }
+    else
+    {
+        write_typed(0xdb, text.size(), 4, output);
+    }
+    output.insert(output.end(), text.begin(), text.end());
+}
+
+/// Writes the header of an array or map, which differ by their type bytes
+void write_container(std::size_t size, uint8_t fix_type, uint8_t type_16,
+                     std::vector<uint8_t>& output)
+{
+    assert(size <= UINT32_MAX && "MessagePack containers are limited");
+    if (size < 16)
+    {
+        output.push_back(uint8_t(fix_type | size));
+    }
+    else if (size <= UINT16_MAX)
+    {
+        write_typed(type_16, size, 2, output);
+    }
+    else
+    {
+        write_typed(type_16 + 1, size, 4, output);
+    }
+}
+}
+
+void write_msgpack(const json& value, std::vector<uint8_t>& output)
+{
+    switch (value.json_type())
+    {
+    case class_type::null:
+        output.push_back(0xc0);
+        return;
+    case class_type::boolean:
+        output.push_back(value.to_bool() ? 0xc3 : 0xc2);
+        return;
+    case class_type::integral:
+        write_integer(value.to_int(), output);
+        return;
+    case class_type::floating:
+    {
+        const double floating = value.to_float();
+        if (is_exact_float(floating))
+        {
+            write_typed(0xca, float_bits(float(floating)), 4, output);
+        }
+        else
+        {
+            write_typed(0xcb, double_bits(floating), 8, output);
+        }
+        return;
+    }
+    case class_type::string:
+        write_text(value.to_string_view(), output);
+        return;
+    case class_type::array:
+        write_container(value.size(), 0x90, 0xdc, output);
+        for (const auto& element : value.array_range())
+        {
+            write_msgpack(element, output);
+        }
+        return;
+    case class_type::object:
+        write_container(value.size(), 0x80, 0xde, output);
+        for (const auto& member : value.object_range())
+        {
+            write_text(member.first.view(), output);
+            write_msgpack(member.second, output);
+        }
+        return;
+    }
+    assert(0 && "Unknown class_type");
+}
+}
+}
+}
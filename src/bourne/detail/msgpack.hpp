@@ -0,0 +1,225 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../error.hpp"
+#include "../json.hpp"
+#include "binary_reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Appends the value encoded as MessagePack. Integers use the shortest
+/// encoding, floating point values are written as float 32 when it holds
+/// them exactly and as float 64 otherwise.
+void write_msgpack(const json& value, std::vector<uint8_t>& output);
+
+/// Reads a MessagePack encoded value and reports it to a handler, with the
+/// same callbacks as basic_parser. Strings are passed as views of the input.
+///
+/// Binary and extension types have no json equivalent and are reported as
+/// bourne::error::decode_unsupported_type.
+template <class Handler>
+class msgpack_reader : public binary_reader<Handler>
+{
+public:
+    using binary_reader<Handler>::binary_reader;
+
+    /// Reads a single value, which must span the whole input
+    void read_document()
+    {
+        read_value();
+        this->end_document();
+    }
+
+private:
+    void read_value()
+    {
+        if (!this->available(1))
+            return;
+        const uint8_t byte = this->next_byte();
+
+        // Positive fixint, fixmap, fixarray, fixstr and negative fixint
+        if (byte <= 0x7f)
+        {
+            this->handle(this->m_handler.on_int(byte));
+            return;
+        }
+        if (byte <= 0x8f)
+        {
+            read_map(byte & 0x0f);
+            return;
+        }
+        if (byte <= 0x9f)
+        {
+            read_array(byte & 0x0f);
+            return;
+        }
+        if (byte <= 0xbf)
+        {
+            read_text(byte & 0x1f, false);
+            return;
+        }
+        if (byte >= 0xe0)
+        {
+            this->handle(this->m_handler.on_int(int8_t(byte)));
+            return;
+        }
+
+        uint64_t argument = 0;
+        switch (byte)
+        {
+        case 0xc0:
+            this->handle(this->m_handler.on_null());
+            return;
+        case 0xc2:
+            this->handle(this->m_handler.on_bool(false));
+            return;
+        case 0xc3:
+            this->handle(this->m_handler.on_bool(true));
+            return;
+        case 0xca:
+            if (this->read_number(4, argument))
+            {
+                this->handle(
+                    this->m_handler.on_double(bits_float(uint32_t(argument))));
+            }
+            return;
+        case 0xcb:
+            if (this->read_number(8, argument))
+                this->handle(this->m_handler.on_double(bits_double(argument)));
+            return;
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            if (this->read_number(std::size_t(1) << (byte - 0xcc), argument))
+                this->report_unsigned(argument);
+            return;
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+            read_signed(std::size_t(1) << (byte - 0xd0));
+            return;
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            if (this->read_number(std::size_t(1) << (byte - 0xd9), argument))
+                read_text(argument, false);
+            return;
+        case 0xdc:
+        case 0xdd:
+            if (this->read_number(std::size_t(2) << (byte - 0xdc), argument))
+                read_array(argument);
+            return;
+        case 0xde:
+        case 0xdf:
+            if (this->read_number(std::size_t(2) << (byte - 0xde), argument))
+                read_map(argument);
+            return;
+        default:
+            // Binary and extension types
+            this->m_error = bourne::error::decode_unsupported_type;
+            return;
+        }
+    }
+
+    void read_signed(std::size_t bytes)
+    {
+        uint64_t argument;
+        if (!this->read_number(bytes, argument))
+            return;
+
+        // Sign extend the value to 64 bits
+        const unsigned shift = unsigned(64 - 8 * bytes);
+        this->handle(
+            this->m_handler.on_int(int64_t(argument << shift) >> shift));
+    }
+
+    void read_text(uint64_t size, bool is_key)
+    {
+        std::string_view text;
+        if (!this->read_string(size, text))
+            return;
+        if (is_key)
+        {
+            this->handle(this->m_handler.on_key(text));
+        }
+        else
+        {
+            this->handle(this->m_handler.on_string(text));
+        }
+    }
+
+    void read_array(uint64_t size)
+    {
+        this->handle(this->m_handler.on_array_begin());
+        if (this->m_error)
+            return;
+        this->reserve(size);
+        for (uint64_t i = 0; i < size && !this->m_error; ++i)
+        {
+            read_value();
+        }
+        if (this->m_error)
+            return;
+        this->handle(this->m_handler.on_array_end());
+    }
+
+    void read_map(uint64_t size)
+    {
+        this->handle(this->m_handler.on_object_begin());
+        if (this->m_error)
+            return;
+        this->reserve(size);
+        for (uint64_t i = 0; i < size && !this->m_error; ++i)
+        {
+            read_member();
+        }
+        if (this->m_error)
+            return;
+        this->handle(this->m_handler.on_object_end());
+    }
+
+    void read_member()
+    {
+        if (!this->available(1))
+            return;
+        const uint8_t byte = this->next_byte();
+        uint64_t size = 0;
+        if (byte >= 0xa0 && byte <= 0xbf)
+        {
+            size = byte & 0x1f;
+        }
+        else if (byte >= 0xd9 && byte <= 0xdb)
+        {
+            if (!this->read_number(std::size_t(1) << (byte - 0xd9), size))
+                return;
+        }
+        else
+        {
+            this->m_error = bourne::error::decode_key_not_string;
+            return;
+        }
+
+        read_text(size, true);
+        if (this->m_error)
+            return;
+        read_value();
+    }
+};
+}
+}
+}
@@ -0,0 +1,152 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "number.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// The powers of ten which are exactly representable as a double
+constexpr double exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// The largest mantissa which is exactly representable as a double
+constexpr uint64_t max_exact_mantissa = uint64_t(1) << 53;
+
+/// Reads a double with the "C" locale, whatever the global locales are.
+/// @return False if the text is out of range
+bool read_classic(std::string_view text, double& value)
+{
+    std::istringstream stream{std::string(text)};
+    stream.imbue(std::locale::classic());
+    stream >> value;
+    return !stream.fail();
+}
+
+/// Converts the number using the correctly rounded conversion of the
+/// standard library, which does not depend on the locale.
+bool convert_text(const decimal_number& number, double& value)
+{
+    // The position of the first digit tells if a number out of range is too
+    // large or too small
+    const bool too_large = int64_t(number.digits) + number.exponent > 0;
+
+#if defined(__cpp_lib_to_chars)
+    auto result = std::from_chars(number.text.data(),
+                                  number.text.data() + number.text.size(),
+                                  value);
+    if (result.ec != std::errc::result_out_of_range)
+        return true;
+    if (too_large)
+        return false;
+
+    // Some versions of the standard library also report subnormal numbers
+    // as out of range, streams convert those.
+#endif
+
+    // Numbers too small to be represented are read as zero
+    return read_classic(number.text, value) || !too_large;
+}
+}
+
+bool to_double(const decimal_number& number, double& value)
+{
+    // Clinger's fast path: When both the mantissa and the power of ten are
+    // exact doubles, a single multiplication or division is correctly
+    // rounded. This only holds when doubles are not evaluated with a higher
+    // precision, as on x87.
+#if FLT_EVAL_METHOD == 0
+    if (number.digits <= max_exact_digits &&
+        number.mantissa <= max_exact_mantissa && number.exponent >= -22 &&
+        number.exponent <= 22)
+    {
+        value = double(number.mantissa);
+        if (number.exponent < 0)
+        {
+            value /= exact_powers_of_ten[-number.exponent];
+        }
+        else
+        {
+            value *= exact_powers_of_ten[number.exponent];
+        }
+        if (number.negative)
+            value = -value;
+        return true;
+    }
+#endif
+
+    return convert_text(number, value);
+}
+
+char* format_int(int64_t value, char* output)
+{
+    auto result = std::to_chars(output, output + max_formatted_size, value);
+    assert(result.ec == std::errc());
+    return result.ptr;
+}
+
+char* format_double(double value, char* output)
+{
+    if (!std::isfinite(value))
+    {
+        std::memcpy(output, "null", 4);
+        return output + 4;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(output, output + max_formatted_size, value);
+    assert(result.ec == std::errc());
+    char* end = result.ptr;
+#else
+    // Without the shortest formatting of to_chars, use the lowest precision
+    // which round-trips. Streams with the "C" locale always write a decimal
+    // point, unlike printf.
+    std::string text;
+    for (int precision = 15; precision <= 17; ++precision)
+    {
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream.precision(precision);
+        stream << value;
+        text = stream.str();
+
+        double read = 0;
+        if (read_classic(text, read) && read == value)
+            break;
+    }
+    assert(text.size() <= max_formatted_size);
+    char* end = std::copy(text.begin(), text.end(), output);
+#endif
+
+    // Whole numbers are written without a decimal point or exponent
+    auto is_whole = [](char c) { return is_digit(c) || c == '-'; };
+    if (std::all_of(output, end, is_whole))
+    {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    return end;
+}
+}
+}
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The largest number of decimal digits which always fits in an uint64_t
+constexpr std::size_t max_exact_digits = 19;
+
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// A decimal number split into its parts by the parser. The value of the
+/// number is mantissa * 10^exponent, negated if negative is set.
+struct decimal_number
+{
+    /// The number as written in the input
+    std::string_view text;
+
+    /// The digits of the number, only valid if digits is at most
+    /// max_exact_digits
+    uint64_t mantissa;
+
+    /// The power of ten to multiply the mantissa with
+    int64_t exponent;
+
+    /// The number of digits in the mantissa, not counting leading zeros
+    std::size_t digits;
+
+    bool negative;
+};
+
+/// Converts a decimal number to the nearest double.
+/// @param value Set to the converted number
+/// @return False if the number is too large to be represented as a double.
+///         Numbers too small to be represented are rounded to zero.
+bool to_double(const decimal_number& number, double& value);
+
+/// The largest number of characters written by format_int() and
+/// format_double()
+constexpr std::size_t max_formatted_size = 32;
+
+/// Writes the integer in decimal.
+/// @param output Buffer of at least max_formatted_size characters
+/// @return Pointer past the last character written
+char* format_int(int64_t value, char* output);
+
+/// Writes the shortest representation of the double which parses back to
+/// the same value. A ".0" is added to whole numbers so they are parsed as
+/// floating point again. Json has no representation for infinity and NaN,
+/// so they are written as null.
+/// @param output Buffer of at least max_formatted_size characters
+/// @return Pointer past the last character written
+char* format_double(double value, char* output);
+}
+}
+}
@@ -6,12 +6,12 @@
 #include "parser.hpp"
 #include "../error.hpp"
 #include "../json.hpp"
+#include "basic_parser.hpp"
+#include "dom_builder.hpp"
+#include "structural_index.hpp"
 #include "throw_if_error.hpp"
 
-#include <cctype>
-#include <cmath>
 #include <cstddef>
-#include <iostream>
 #include <string>
 #include <system_error>
 
@@ -21,380 +21,61 @@ inline namespace STEINWURF_BOURNE_VERSION
 {
 namespace detail
 {
-json parser::parse(const std::string& input)
+json parser::parse(std::string_view input)
 {
     return parse(input, json::parse_options{});
 }
 
-json parser::parse(const std::string& input, const json::parse_options& options)
+json parser::parse(std::string_view input, const json::parse_options& options)
 {
     std::error_code error;
-    std::size_t offset = 0;
-    auto result = parse_next(input, offset, error, options);
-    if (error)
-    {
-        throw_if_error(error);
-    }
-    consume_white_space(input, offset);
-    if (offset != input.size())
-    {
-        error = bourne::error::parse_found_multiple_unstructured_elements;
-        throw_if_error(error);
-    }
+    auto result = parse(input, options, error);
     throw_if_error(error);
     return result;
 }
 
-json parser::parse(const std::string& input, std::error_code& error)
+json parser::parse(std::string_view input, std::error_code& error)
 {
     return parse(input, json::parse_options{}, error);
 }
 
-json parser::parse(const std::string& input, const json::parse_options& options,
+json parser::parse(std::string_view input, const json::parse_options& options,
                    std::error_code& error)
 {
-    assert(!error);
-    std::size_t offset = 0;
-    auto result = parse_next(input, offset, error, options);
-    if (error)
-        return result;
-    consume_white_space(input, offset);
-    if (offset != input.size())
-    {
-        error = bourne::error::parse_found_multiple_unstructured_elements;
-        return json(class_type::null);
-    }
-    assert(offset == input.size());
-    return result;
-}
-
-void parser::consume_white_space(const std::string& input, size_t& offset)
-{
-    while (offset < input.size() && isspace(input[offset]))
-    {
-        offset++;
-    }
-}
-
-json parser::parse_object(const std::string& input, size_t& offset,
-                          std::error_code& error,
-                          const json::parse_options& options)
-{
-    assert(!error);
-    json object = json(class_type::object);
-
-    offset++;
-    consume_white_space(input, offset);
-    if (input[offset] == '}')
-    {
-        offset++;
-        return object;
-    }
-
-    while (true)
-    {
-        json key = parse_next(input, offset, error, options);
-        if (error)
-            return json(class_type::null);
-
-        consume_white_space(input, offset);
-        if (input[offset] != ':')
-        {
-            error = bourne::error::parse_object_expected_colon;
-            return json(class_type::null);
-        }
-        offset++;
-        consume_white_space(input, offset);
-        json value = parse_next(input, offset, error, options);
-        if (error)
-            return json(class_type::null);
-
-        std::string key_string = key.to_string();
-        if (options.strict && object.has_key(key_string))
-        {
-            error = bourne::error::parse_object_duplicate_key;
-            return json(class_type::null);
-        }
-        object[key_string] = value;
-
-        consume_white_space(input, offset);
-        if (input[offset] == ',')
-        {
-            offset++;
-            continue;
-        }
-        else if (input[offset] == '}')
-        {
-            offset++;
-            break;
-        }
-        else
-        {
-            error = bourne::error::parse_object_expected_comma;
-            return json(class_type::null);
-        }
-    }
-
-    return object;
+    return parse(input, options, nullptr, error);
 }
 
-json parser::parse_array(const std::string& input, size_t& offset,
-                         std::error_code& error,
-                         const json::parse_options& options)
+json parser::parse(std::string_view input, const json::parse_options& options,
+                   arena* arena, std::error_code& error)
 {
     assert(!error);
-    json array = json(class_type::array);
-    std::size_t index = 0;
-
-    offset++;
-    consume_white_space(input, offset);
-    if (input[offset] == ']')
-    {
-        offset++;
-        return array;
-    }
-
-    while (true)
-    {
-        array[index++] = parse_next(input, offset, error, options);
-        if (error)
-            return json(class_type::null);
-        consume_white_space(input, offset);
-
-        if (input[offset] == ',')
-        {
-            offset++;
-            continue;
-        }
-        else if (input[offset] == ']')
-        {
-            offset++;
-            break;
-        }
-        else
-        {
-            error =
-                bourne::error::parse_array_expected_comma_or_closing_bracket;
-            return json(class_type::null);
-        }
-    }
-
-    return array;
-}
-
-json parser::parse_string(const std::string& input, size_t& offset,
-                          std::error_code& error)
-{
-    assert(!error);
-    json string;
-    std::string val;
-    for (char c = input[++offset]; c != '\"'; c = input[++offset])
-    {
-        if (c == '\\')
-        {
-            switch (input[++offset])
-            {
-            case '\"':
-                val += '\"';
-                break;
-            case '\\':
-                val += '\\';
-                break;
-            case '/':
-                val += '/';
-                break;
-            case 'b':
-                val += '\b';
-                break;
-            case 'f':
-                val += '\f';
-                break;
-            case 'n':
-                val += '\n';
-                break;
-            case 'r':
-                val += '\r';
-                break;
-            case 't':
-                val += '\t';
-                break;
-            case 'u':
-            {
-                val += "\\u";
-                for (std::size_t i = 1; i <= 4; ++i)
-                {
-                    c = input[offset + i];
-                    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
-                        (c >= 'A' && c <= 'F'))
-                    {
-                        val += c;
-                    }
-                    else
-                    {
-                        error = bourne::error::
-                            parse_string_expected_unicode_escape_hex_char;
-                        return json(class_type::null);
-                    }
-                }
-                offset += 4;
-                break;
-            }
-            default:
-                val += '\\';
-                break;
-            }
-        }
-        else
-        {
-            val += c;
-        }
-    }
-    offset++;
-    string = val;
-    return string;
-}
-
-json parser::parse_number(const std::string& input, size_t& offset,
-                          std::error_code& error)
-{
-    assert(!error);
-    json number;
-    std::string val;
-    char c;
-    bool is_floating = false;
-    int64_t exp = 0;
-    while (true)
-    {
-        c = input[offset++];
-        if ((c == '-') || (c >= '0' && c <= '9'))
-        {
-            val += c;
-        }
-        else if (c == '.' && !is_floating)
-        {
-            val += c;
-            is_floating = true;
-        }
-        else
-        {
-            break;
-        }
-    }
-    if (tolower(c) == 'e')
-    {
-        std::string exp_str;
-
-        c = input[offset++];
-        if (c == '-')
-        {
-            offset++;
-            exp_str += '-';
-        }
-
-        while (true)
-        {
-            c = input[offset++];
-            if (c >= '0' && c <= '9')
-            {
-                exp_str += c;
-            }
-            else if (!isspace(c) && c != ',' && c != ']' && c != '}')
-            {
-                error =
-                    bourne::error::parse_number_expected_number_for_component;
-                return json(class_type::null);
-            }
-            else
-            {
-                break;
-            }
-        }
-        exp = std::stoll(exp_str);
-    }
-    else if (!isspace(c) && c != ',' && c != ']' && c != '}')
-    {
-        error = bourne::error::parse_number_unexpected_char;
+    dom_builder builder(options, arena, input, error);
+    parse_with(input, options, builder, error);
+    if (error)
         return json(class_type::null);
-    }
-    --offset;
-
-    if (is_floating)
-    {
-        number = std::stod(val) * std::pow(10, exp);
-    }
-    else
-    {
-        number = std::stoll(val) * (uint64_t)std::pow(10, exp);
-    }
-    return number;
+    return builder.release();
 }
 
-json parser::parse_bool(const std::string& input, size_t& offset,
-                        std::error_code& error)
+void parser::parse(std::string_view input, const json::parse_options& options,
+                   handler& handler, std::error_code& error)
 {
     assert(!error);
-    json boolean;
-    if (input.substr(offset, 4) == "true")
-    {
-        offset += 4;
-        return json(true);
-    }
-    else if (input.substr(offset, 5) == "false")
-    {
-        offset += 5;
-        return json(false);
-    }
-    else
-    {
-        error = bourne::error::parse_boolean_expected_true_or_false;
-        return json(class_type::null);
-    }
+    parse_with(input, options, handler, error);
 }
 
-json parser::parse_null(const std::string& input, size_t& offset,
+template <class Handler>
+void parser::parse_with(std::string_view input,
+                        const json::parse_options& options, Handler& handler,
                         std::error_code& error)
 {
-    assert(!error);
-    if (input.substr(offset, 4) != "null")
+    if (options.two_stage && input.size() <= structural_index::max_size)
     {
-        error = bourne::error::parse_null_expected_null;
-        return json(class_type::null);
+        structural_index index(input.data(), input.size());
+        basic_parser<Handler>(input, handler, error, &index).parse_document();
+        return;
     }
-    offset += 4;
-    return json(class_type::null);
-}
 
-json parser::parse_next(const std::string& input, size_t& offset,
-                        std::error_code& error,
-                        const json::parse_options& options)
-{
-    assert(!error);
-    char value;
-    consume_white_space(input, offset);
-    value = input[offset];
-    switch (value)
-    {
-    case '[':
-        return parse_array(input, offset, error, options);
-    case '{':
-        return parse_object(input, offset, error, options);
-    case '\"':
-        return parse_string(input, offset, error);
-    case 't':
-    case 'f':
-        return parse_bool(input, offset, error);
-    case 'n':
-        return parse_null(input, offset, error);
-    default:
-    {
-        if ((value <= '9' && value >= '0') || value == '-')
-        {
-            return parse_number(input, offset, error);
-        }
-    }
-    }
-    error = bourne::error::parse_next_unexpected_char;
-    return json(class_type::null);
+    basic_parser<Handler>(input, handler, error, nullptr).parse_document();
 }
 }
 }
@@ -6,9 +6,12 @@
 #pragma once
 
 #include "../error.hpp"
+#include "../handler.hpp"
 #include "../json.hpp"
+#include "arena.hpp"
 
 #include <string>
+#include <string_view>
 #include <system_error>
 
 namespace bourne
@@ -21,33 +24,30 @@ class parser
 {
 
 public:
-    static json parse(const std::string& input);
-    static json parse(const std::string& input, std::error_code& error);
-    static json parse(const std::string& input,
+    static json parse(std::string_view input);
+    static json parse(std::string_view input, std::error_code& error);
+    static json parse(std::string_view input,
                       const json::parse_options& options);
-    static json parse(const std::string& input,
+    static json parse(std::string_view input,
                       const json::parse_options& options,
                       std::error_code& error);
 
+    /// Parses the input allocating the values from the given arena, or the
+    /// heap if arena is nullptr.
+    static json parse(std::string_view input,
+                      const json::parse_options& options, arena* arena,
+                      std::error_code& error);
+
+    /// Parses the input reporting the values found to the handler.
+    static void parse(std::string_view input,
+                      const json::parse_options& options, handler& handler,
+                      std::error_code& error);
+
 private:
-    static void consume_white_space(const std::string& input, size_t& offset);
-    static json parse_object(const std::string& input, size_t& offset,
-                             std::error_code& error,
-                             const json::parse_options& options);
-    static json parse_array(const std::string& input, size_t& offset,
-                            std::error_code& error,
-                            const json::parse_options& options);
-    static json parse_string(const std::string& input, size_t& offset,
-                             std::error_code& error);
-    static json parse_number(const std::string& input, size_t& offset,
-                             std::error_code& error);
-    static json parse_bool(const std::string& input, size_t& offset,
-                           std::error_code& error);
-    static json parse_null(const std::string& input, size_t& offset,
-                           std::error_code& error);
-    static json parse_next(const std::string& input, size_t& offset,
-                           std::error_code& error,
-                           const json::parse_options& options);
+    template <class Handler>
+    static void parse_with(std::string_view input,
+                           const json::parse_options& options,
+                           Handler& handler, std::error_code& error);
 };
 }
 }
@@ -0,0 +1,461 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "path.hpp"
+#include "number.hpp"
+
+#include "../error.hpp"
+
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// Reads a JSONPath from the start to the end, failing with
+/// bourne::error::path_invalid_syntax at the first character which is not
+/// supported
+class path_reader
+{
+public:
+    path_reader(std::string_view path, std::error_code& error) :
+        m_path(path), m_error(error)
+    {
+    }
+
+    path_plan read()
+    {
+        path_plan plan;
+        if (!consume('$'))
+            return fail();
+
+        while (!m_error && m_position < m_path.size())
+        {
+            path_segment segment;
+            if (consume('.'))
+            {
+                segment.m_descendant = consume('.');
+                if (segment.m_descendant && peek() == '[')
+                    read_bracket(segment);
+                else
+                    read_dot(segment);
+            }
+            else if (peek() == '[')
+            {
+                read_bracket(segment);
+            }
+            else
+            {
+                return fail();
+            }
+            plan.m_segments.push_back(std::move(segment));
+        }
+
+        if (m_error)
+            return path_plan();
+        return plan;
+    }
+
+private:
+    /// Reads the selector of a segment written as .name or .*
+    void read_dot(path_segment& segment)
+    {
+        if (consume('*'))
+        {
+            segment.m_selector = path_selector::wildcard;
+            return;
+        }
+        segment.m_selector = path_selector::name;
+        segment.m_name = std::string(read_name());
+        if (segment.m_name.empty())
+            fail();
+    }
+
+    /// Reads the selector of a segment written in brackets
+    void read_bracket(path_segment& segment)
+    {
+        consume('[');
+        skip_whitespace();
+        const char c = peek();
+        if (c == '\'' || c == '"')
+        {
+            segment.m_selector = path_selector::name;
+            segment.m_name = read_string();
+        }
+        else if (consume('*'))
+        {
+            segment.m_selector = path_selector::wildcard;
+        }
+        else if (consume('?'))
+        {
+            segment.m_selector = path_selector::filter;
+            read_filter(segment.m_filter);
+        }
+        else
+        {
+            read_index_or_slice(segment);
+        }
+        skip_whitespace();
+        if (!consume(']'))
+            fail();
+    }
+
+    /// Reads [index] or [start:end:step], with each part of the slice
+    /// optional
+    void read_index_or_slice(path_segment& segment)
+    {
+        segment.m_selector = path_selector::index;
+        segment.m_has_start = read_integer(segment.m_start);
+        skip_whitespace();
+        if (!consume(':'))
+        {
+            if (!segment.m_has_start)
+                fail();
+            return;
+        }
+
+        segment.m_selector = path_selector::slice;
+        skip_whitespace();
+        segment.m_has_end = read_integer(segment.m_end);
+        skip_whitespace();
+        if (consume(':'))
+        {
+            skip_whitespace();
+            if (!read_integer(segment.m_step))
+                segment.m_step = 1;
+        }
+    }
+
+    /// Reads a filter written as ?(@.name op literal) or ?@.name op literal
+    void read_filter(path_filter& filter)
+    {
+        skip_whitespace();
+        const bool parenthesis = consume('(');
+        skip_whitespace();
+        filter.m_operand = read_relative_path();
+        skip_whitespace();
+        filter.m_operator = read_operator();
+        if (filter.m_operator != path_operator::exists)
+        {
+            skip_whitespace();
+            filter.m_literal = read_literal();
+        }
+        skip_whitespace();
+        if (parenthesis && !consume(')'))
+            fail();
+    }
+
+    /// Reads the operand of a filter, such as @.a.b or @['a'][0], as a
+    /// pointer relative to the value filtered
+    compiled_pointer read_relative_path()
+    {
+        if (!consume('@'))
+        {
+            fail();
+            return compiled_pointer();
+        }
+
+        std::string pointer;
+        while (!m_error)
+        {
+            std::string token;
+            if (consume('.'))
+            {
+                token = std::string(read_name());
+                if (token.empty())
+                    fail();
+            }
+            else if (consume('['))
+            {
+                skip_whitespace();
+                const char c = peek();
+                int64_t index = 0;
+                if (c == '\'' || c == '"')
+                    token = read_string();
+                else if (read_integer(index) && index >= 0)
+                    token = std::to_string(index);
+                else
+                    fail();
+                skip_whitespace();
+                if (!consume(']'))
+                    fail();
+            }
+            else
+            {
+                break;
+            }
+
+            pointer += '/';
+            for (char t : token)
+            {
+                if (t == '~')
+                    pointer += "~0";
+                else if (t == '/')
+                    pointer += "~1";
+                else
+                    pointer += t;
+            }
+        }
+
+        if (m_error)
+            return compiled_pointer();
+        return compiled_pointer::parse(pointer, m_error);
+    }
+
+    path_operator read_operator()
+    {
+        const std::string_view rest = m_path.substr(m_position);
+        for (const auto& candidate :
+             {std::make_pair("==", path_operator::equal),
+              std::make_pair("!=", path_operator::not_equal),
+              std::make_pair("<=", path_operator::less_equal),
+              std::make_pair(">=", path_operator::greater_equal),
+              std::make_pair("<", path_operator::less),
+              std::make_pair(">", path_operator::greater)})
+        {
+            const std::string_view token = candidate.first;
+            if (rest.substr(0, token.size()) == token)
+            {
+                m_position += token.size();
+                return candidate.second;
+            }
+        }
+        return path_operator::exists;
+    }
+
+    /// Reads a string, number, true, false or null
+    json read_literal()
+    {
+        const char c = peek();
+        if (c == '\'' || c == '"')
+            return json(read_string());
+
+        const std::size_t begin = m_position;
+        while (m_position < m_path.size() &&
+               (is_name_char(peek()) || peek() == '+' || peek() == '.'))
+        {
+            ++m_position;
+        }
+
+        std::error_code error;
+        auto literal = json::parse(m_path.substr(begin, m_position - begin),
+                                   error);
+        if (error || literal.is_array() || literal.is_object())
+        {
+            fail();
+            return json();
+        }
+        return literal;
+    }
+
+    /// Reads a string in single or double quotes, in which the quotes and
+    /// backslashes are escaped with a backslash
+    std::string read_string()
+    {
+        const char quote = peek();
+        ++m_position;
+        std::string string;
+        while (m_position < m_path.size() && peek() != quote)
+        {
+            if (peek() == '\\')
+                ++m_position;
+            if (m_position == m_path.size())
+                break;
+            string += peek();
+            ++m_position;
+        }
+        if (!consume(quote))
+            fail();
+        return string;
+    }
+
+    /// Reads an optionally negative integer
+    /// @return False if there is none
+    bool read_integer(int64_t& value)
+    {
+        const bool negative = consume('-');
+        if (!is_digit(peek()))
+        {
+            if (negative)
+                fail();
+            return false;
+        }
+
+        uint64_t magnitude = 0;
+        while (is_digit(peek()))
+        {
+            magnitude = magnitude * 10 + uint64_t(peek() - '0');
+            if (magnitude > uint64_t(std::numeric_limits<int64_t>::max()))
+            {
+                fail();
+                return false;
+            }
+            ++m_position;
+        }
+        value = negative ? -int64_t(magnitude) : int64_t(magnitude);
+        return true;
+    }
+
+    std::string_view read_name()
+    {
+        const std::size_t begin = m_position;
+        while (m_position < m_path.size() && is_name_char(peek()))
+            ++m_position;
+        return m_path.substr(begin, m_position - begin);
+    }
+
+    static bool is_name_char(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               is_digit(c) || c == '_' || c == '-' ||
+               static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    void skip_whitespace()
+    {
+        while (m_position < m_path.size() &&
+               (peek() == ' ' || peek() == '\t' || peek() == '\n'))
+        {
+            ++m_position;
+        }
+    }
+
+    /// @return The next character or zero at the end of the path
+    char peek() const
+    {
+        return m_position < m_path.size() ? m_path[m_position] : '\0';
+    }
+
+    bool consume(char c)
+    {
+        if (m_error || peek() != c)
+            return false;
+        ++m_position;
+        return true;
+    }
+
+    path_plan fail()
+    {
+        if (!m_error)
+            m_error = bourne::error::path_invalid_syntax;
+        return path_plan();
+    }
+
+private:
+    std::string_view m_path;
+    std::size_t m_position = 0;
+    std::error_code& m_error;
+};
+
+/// @return The comparison of two values of the same kind as -1, 0 or 1, or
+///         2 if they cannot be ordered
+int compare(const json& a, const json& b)
+{
+    if (a.is_float() && b.is_float())
+    {
+        if (a.is_int() && b.is_int())
+            return a.to_int() < b.to_int() ? -1 : a.to_int() > b.to_int();
+        return a.to_float() < b.to_float() ? -1 : a.to_float() > b.to_float();
+    }
+    if (a.is_string() && b.is_string())
+    {
+        const int result = a.to_string_view().compare(b.to_string_view());
+        return result < 0 ? -1 : result > 0;
+    }
+    return 2;
+}
+}
+
+path_plan parse_path(std::string_view path, std::error_code& error)
+{
+    assert(!error);
+    return path_reader(path, error).read();
+}
+
+path_match match_child(const path_segment& segment, bool array,
+                       std::string_view key, std::size_t index)
+{
+    switch (segment.m_selector)
+    {
+    case path_selector::name:
+        return !array && key == segment.m_name ? path_match::yes
+                                               : path_match::no;
+    case path_selector::wildcard:
+        return path_match::yes;
+    case path_selector::filter:
+        return path_match::child_needed;
+    case path_selector::index:
+        if (!array)
+            return path_match::no;
+        if (segment.m_start < 0)
+            return path_match::size_needed;
+        return index == uint64_t(segment.m_start) ? path_match::yes
+                                                  : path_match::no;
+    case path_selector::slice:
+    {
+        if (!array)
+            return path_match::no;
+        if (segment.m_step <= 0 ||
+            (segment.m_has_start && segment.m_start < 0) ||
+            (segment.m_has_end && segment.m_end < 0))
+        {
+            return segment.m_step == 0 ? path_match::no
+                                       : path_match::size_needed;
+        }
+        const uint64_t start =
+            segment.m_has_start ? uint64_t(segment.m_start) : 0;
+        if (index < start ||
+            (segment.m_has_end && index >= uint64_t(segment.m_end)))
+        {
+            return path_match::no;
+        }
+        return (index - start) % uint64_t(segment.m_step) == 0
+                   ? path_match::yes
+                   : path_match::no;
+    }
+    }
+    return path_match::no;
+}
+
+bool match_filter(const json& value, const path_filter& filter)
+{
+    std::error_code error;
+    const json& operand = value.at_pointer(filter.m_operand, error);
+    if (error)
+        return false;
+
+    if (filter.m_operator == path_operator::exists)
+        return true;
+
+    const int order = compare(operand, filter.m_literal);
+    const bool equal =
+        order == 0 || (order == 2 && operand == filter.m_literal);
+    switch (filter.m_operator)
+    {
+    case path_operator::exists:
+    case path_operator::equal:
+        return equal;
+    case path_operator::not_equal:
+        return !equal;
+    case path_operator::less:
+        return order == -1;
+    case path_operator::less_equal:
+        return order == -1 || order == 0;
+    case path_operator::greater:
+        return order == 1;
+    case path_operator::greater_equal:
+        return order == 1 || order == 0;
+    }
+    return false;
+}
+}
+}
+}
@@ -0,0 +1,256 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../compiled_pointer.hpp"
+#include "../json.hpp"
+#include "../version.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The comparison of a filter selector
+enum class path_operator
+{
+    exists,
+    equal,
+    not_equal,
+    less,
+    less_equal,
+    greater,
+    greater_equal
+};
+
+/// A filter selector, such as [?(@.severity > 3)]
+struct path_filter
+{
+    /// The value compared, relative to the value filtered
+    compiled_pointer m_operand;
+
+    path_operator m_operator = path_operator::exists;
+
+    /// The value the operand is compared with, unless the filter only
+    /// checks that the operand exists
+    json m_literal;
+};
+
+/// The kinds of selectors of a segment
+enum class path_selector
+{
+    /// A member with a given name, such as .name or ['name']
+    name,
+
+    /// All members or elements, .* or [*]
+    wildcard,
+
+    /// The element at an index, such as [3] or [-1]
+    index,
+
+    /// The elements of a slice, such as [1:10:2]
+    slice,
+
+    /// The members or elements matching a filter, such as [?(@.id)]
+    filter
+};
+
+/// A segment of a JSONPath, which selects children of the values selected
+/// by the segments before it
+struct path_segment
+{
+    /// Set for the segments written with "..", which select from the
+    /// value and all of its descendants
+    bool m_descendant = false;
+
+    path_selector m_selector = path_selector::wildcard;
+
+    /// The name of a name selector
+    std::string m_name;
+
+    /// The index of an index selector, or the start of a slice
+    int64_t m_start = 0;
+
+    /// The end of a slice
+    int64_t m_end = 0;
+
+    /// The step of a slice
+    int64_t m_step = 1;
+
+    /// Set if the slice has a start
+    bool m_has_start = false;
+
+    /// Set if the slice has an end
+    bool m_has_end = false;
+
+    /// The filter of a filter selector
+    path_filter m_filter;
+};
+
+/// A compiled JSONPath
+struct path_plan
+{
+    std::vector<path_segment> m_segments;
+};
+
+/// Whether a child of a value is selected by a segment, knowing only its
+/// key or index
+enum class path_match
+{
+    no,
+    yes,
+
+    /// The child must be read to know, as for filters
+    child_needed,
+
+    /// The number of children must be known, as for negative indices
+    size_needed
+};
+
+/// Parses a JSONPath, such as $.events[?(@.severity > 3)].id. Fails with
+/// bourne::error::path_invalid_syntax if the path is not supported.
+path_plan parse_path(std::string_view path, std::error_code& error);
+
+/// @return Whether the segment selects the member with the key, or the
+///         element at the index if the parent is an array
+path_match match_child(const path_segment& segment, bool array,
+                       std::string_view key, std::size_t index);
+
+/// @return True if the value matches the filter
+bool match_filter(const json& value, const path_filter& filter);
+
+/// Calls function(child) for each child of the value selected by the
+/// segment, ignoring whether the segment selects descendants.
+template <class Function>
+void select_children(const json& value, const path_segment& segment,
+                     Function&& function)
+{
+    if (value.is_object())
+    {
+        if (segment.m_selector == path_selector::name)
+        {
+            if (value.has_key(segment.m_name))
+                function(value[segment.m_name]);
+            return;
+        }
+        for (const auto& member : value.object_range())
+        {
+            if (segment.m_selector == path_selector::wildcard ||
+                (segment.m_selector == path_selector::filter &&
+                 match_filter(member.second, segment.m_filter)))
+            {
+                function(member.second);
+            }
+        }
+        return;
+    }
+
+    if (!value.is_array())
+        return;
+
+    const int64_t size = int64_t(value.size());
+    switch (segment.m_selector)
+    {
+    case path_selector::name:
+        break;
+    case path_selector::index:
+    {
+        const int64_t index =
+            segment.m_start < 0 ? segment.m_start + size : segment.m_start;
+        if (index >= 0 && index < size)
+            function(value[std::size_t(index)]);
+        break;
+    }
+    case path_selector::slice:
+    {
+        // The bounds are normalized as in RFC 9535 section 2.3.4.2.2
+        const int64_t step = segment.m_step;
+        if (step == 0)
+            break;
+        auto normalize = [size](int64_t i) { return i < 0 ? i + size : i; };
+        auto clamp = [](int64_t i, int64_t low, int64_t high)
+        { return i < low ? low : i > high ? high : i; };
+        if (step > 0)
+        {
+            const int64_t start =
+                segment.m_has_start ? normalize(segment.m_start) : 0;
+            const int64_t end =
+                segment.m_has_end ? normalize(segment.m_end) : size;
+            for (int64_t i = clamp(start, 0, size); i < clamp(end, 0, size);
+                 i += step)
+            {
+                function(value[std::size_t(i)]);
+            }
+        }
+        else
+        {
+            const int64_t start =
+                segment.m_has_start ? normalize(segment.m_start) : size - 1;
+            const int64_t end =
+                segment.m_has_end ? normalize(segment.m_end) : -size - 1;
+            const int64_t lower = clamp(end, -1, size - 1);
+            for (int64_t i = clamp(start, -1, size - 1); lower < i; i += step)
+            {
+                function(value[std::size_t(i)]);
+            }
+        }
+        break;
+    }
+    case path_selector::wildcard:
+    case path_selector::filter:
+        for (const auto& element : value.array_range())
+        {
+            if (segment.m_selector == path_selector::wildcard ||
+                match_filter(element, segment.m_filter))
+            {
+                function(element);
+            }
+        }
+        break;
+    }
+}
+
+/// Calls function(selected) for each value selected by the segments from
+/// the first one on, in the value.
+template <class Function>
+void evaluate_path(const json& value, const std::vector<path_segment>& segments,
+                   std::size_t first, Function& function)
+{
+    if (first == segments.size())
+    {
+        function(value);
+        return;
+    }
+
+    const path_segment& segment = segments[first];
+    select_children(value, segment, [&](const json& child)
+                    { evaluate_path(child, segments, first + 1, function); });
+
+    if (!segment.m_descendant)
+        return;
+
+    if (value.is_object())
+    {
+        for (const auto& member : value.object_range())
+            evaluate_path(member.second, segments, first, function);
+    }
+    else if (value.is_array())
+    {
+        for (const auto& element : value.array_range())
+            evaluate_path(element, segments, first, function);
+    }
+}
+}
+}
+}
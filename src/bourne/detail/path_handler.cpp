@@ -0,0 +1,302 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "path_handler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+path_handler::capture_state::capture_state(const json::parse_options& options,
+                                           std::error_code& error) :
+    m_builder(options, nullptr, std::string_view(), error)
+{
+}
+
+path_handler::path_handler(const path_plan& plan) :
+    m_segments(plan.m_segments)
+{
+}
+
+bool path_handler::on_null()
+{
+    const std::size_t positions = begin_value(class_type::null);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_null();
+    m_positions.resize(positions);
+    end_value();
+    return true;
+}
+
+bool path_handler::on_bool(bool value)
+{
+    const std::size_t positions = begin_value(class_type::boolean);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_bool(value);
+    m_positions.resize(positions);
+    end_value();
+    return true;
+}
+
+bool path_handler::on_int(int64_t value)
+{
+    const std::size_t positions = begin_value(class_type::integral);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_int(value);
+    m_positions.resize(positions);
+    end_value();
+    return true;
+}
+
+bool path_handler::on_double(double value)
+{
+    const std::size_t positions = begin_value(class_type::floating);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_double(value);
+    m_positions.resize(positions);
+    end_value();
+    return true;
+}
+
+bool path_handler::on_string(std::string_view value)
+{
+    const std::size_t positions = begin_value(class_type::string);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_string(value);
+    m_positions.resize(positions);
+    end_value();
+    return true;
+}
+
+bool path_handler::on_object_begin()
+{
+    const std::size_t positions = begin_value(class_type::object);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_object_begin();
+    m_stack.push_back({positions, false, 0, std::string(), 0, {}});
+    return true;
+}
+
+bool path_handler::on_key(std::string_view key)
+{
+    m_stack.back().m_key.assign(key.data(), key.size());
+    for (auto& capture : m_captures)
+        capture->m_builder.on_key(key);
+    return true;
+}
+
+bool path_handler::on_object_end()
+{
+    for (auto& capture : m_captures)
+        capture->m_builder.on_object_end();
+    m_positions.resize(m_stack.back().m_positions);
+    m_stack.pop_back();
+    end_value();
+    return true;
+}
+
+bool path_handler::on_array_begin()
+{
+    const std::size_t positions = begin_value(class_type::array);
+    for (auto& capture : m_captures)
+        capture->m_builder.on_array_begin();
+    m_stack.push_back({positions, true, 0, std::string(), 0, {}});
+    return true;
+}
+
+bool path_handler::on_array_end()
+{
+    for (auto& capture : m_captures)
+        capture->m_builder.on_array_end();
+    m_positions.resize(m_stack.back().m_positions);
+    m_stack.pop_back();
+    end_value();
+    return true;
+}
+
+json path_handler::release()
+{
+    assert(m_captures.empty());
+    json result(class_type::array);
+    for (auto& slot : m_slots)
+    {
+        // The values are moved when they are selected for the last time
+        for (std::size_t i = 1; i <= slot.m_count; ++i)
+        {
+            const bool last = i == slot.m_count;
+            if (!slot.m_many)
+            {
+                result.append(last ? std::move(slot.m_value) : slot.m_value);
+                continue;
+            }
+            for (auto& value : slot.m_value.array_range())
+                result.append(last ? std::move(value) : value);
+        }
+    }
+    m_slots.clear();
+    return result;
+}
+
+std::size_t path_handler::begin_value(class_type type)
+{
+    const std::size_t begin = m_positions.size();
+    auto add = [this, begin](std::size_t segment, std::size_t count)
+    {
+        auto it = std::find_if(m_positions.begin() + begin, m_positions.end(),
+                               [segment](const position& position)
+                               { return position.m_segment == segment; });
+        if (it != m_positions.end())
+            it->m_count += count;
+        else
+            m_positions.push_back({segment, count});
+    };
+
+    if (m_stack.empty())
+    {
+        // The root value matches the "$" the path starts with
+        add(0, 1);
+    }
+    else
+    {
+        frame& parent = m_stack.back();
+        parent.m_member_slots = m_slots.size();
+        const std::size_t index = parent.m_array ? parent.m_next_index++ : 0;
+        for (std::size_t i = parent.m_positions; i < begin; ++i)
+        {
+            const position position = m_positions[i];
+            const path_segment& segment = m_segments[position.m_segment];
+            if (segment.m_descendant)
+                add(position.m_segment, position.m_count);
+
+            switch (match_child(segment, parent.m_array, parent.m_key, index))
+            {
+            case path_match::yes:
+                add(position.m_segment + 1, position.m_count);
+                break;
+            case path_match::child_needed:
+                capture(position.m_segment, true, position.m_count);
+                break;
+            case path_match::no:
+            case path_match::size_needed:
+                break;
+            }
+        }
+    }
+
+    // A value which matches the whole path is selected, and the position
+    // past the last segment is not followed into its children
+    const std::size_t last = m_segments.size();
+    auto end = std::find_if(m_positions.begin() + begin, m_positions.end(),
+                            [last](const position& position)
+                            { return position.m_segment == last; });
+    if (end != m_positions.end())
+    {
+        const std::size_t count = end->m_count;
+        m_positions.erase(end);
+        capture(last, false, count);
+    }
+
+    if (type == class_type::array)
+    {
+        for (std::size_t i = begin; i < m_positions.size(); ++i)
+        {
+            const position position = m_positions[i];
+            if (match_child(m_segments[position.m_segment], true,
+                            std::string_view(), 0) == path_match::size_needed)
+            {
+                capture(position.m_segment, false, position.m_count);
+            }
+        }
+    }
+    return begin;
+}
+
+void path_handler::end_value()
+{
+    while (!m_captures.empty() && m_captures.back()->m_depth == m_stack.size())
+    {
+        std::unique_ptr<capture_state> capture = std::move(m_captures.back());
+        m_captures.pop_back();
+
+        json value = capture->m_builder.release();
+        slot& slot = m_slots[capture->m_slot];
+        if (!slot.m_many)
+        {
+            slot.m_value = std::move(value);
+            continue;
+        }
+
+        auto select = [&slot](const json& selected)
+        { slot.m_value.append(selected); };
+        const std::size_t next = capture->m_segment + 1;
+        const path_segment& segment = m_segments[capture->m_segment];
+        if (capture->m_filter)
+        {
+            if (match_filter(value, segment.m_filter))
+                evaluate_path(value, m_segments, next, select);
+        }
+        else
+        {
+            auto evaluate = [&](const json& child)
+            { evaluate_path(child, m_segments, next, select); };
+            select_children(value, segment, evaluate);
+        }
+    }
+
+    if (!m_stack.empty() && !m_stack.back().m_array)
+        end_member();
+}
+
+void path_handler::end_member()
+{
+    frame& object = m_stack.back();
+    const std::size_t begin = object.m_member_slots;
+    const std::size_t end = m_slots.size();
+    if (begin == end && object.m_members.empty())
+        return;
+
+    // Only the last member with a key is kept when the object is built, so
+    // the values selected from earlier ones are dropped
+    auto member = object.m_members.find(object.m_key);
+    if (member != object.m_members.end())
+    {
+        for (std::size_t i = member->second.first; i < member->second.second;
+             ++i)
+        {
+            m_slots[i].m_value = json();
+            m_slots[i].m_count = 0;
+        }
+        member->second = {begin, end};
+    }
+    else if (begin != end)
+    {
+        object.m_members.emplace(object.m_key, std::make_pair(begin, end));
+    }
+}
+
+void path_handler::capture(std::size_t segment, bool filter,
+                           std::size_t count)
+{
+    const bool many = segment != m_segments.size();
+    m_slots.push_back(
+        {many ? json(class_type::array) : json(class_type::null), many,
+         count});
+
+    auto state = std::make_unique<capture_state>(m_options, m_error);
+    state->m_depth = m_stack.size();
+    state->m_slot = m_slots.size() - 1;
+    state->m_segment = segment;
+    state->m_filter = filter;
+    m_captures.push_back(std::move(state));
+}
+}
+}
+}
@@ -0,0 +1,176 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../class_type.hpp"
+#include "../handler.hpp"
+#include "../json.hpp"
+#include "dom_builder.hpp"
+#include "path.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Parser handler which evaluates a JSONPath while the input is parsed, and
+/// only builds the values which may be selected.
+///
+/// Every value is assigned the positions in the path it has matched so
+/// far, computed from the positions of its parent and its key or index,
+/// with the number of ways it matched each of them. A value which matches
+/// the whole path is built and selected once for each way it matched, as
+/// select() does. Selectors
+/// which cannot be decided from a key or index build only what they need:
+/// a filter builds each child it tests, and a negative index or slice the
+/// array it selects from. The rest of the path is then evaluated on the
+/// value built.
+///
+/// The values are selected in the order they start in the input. Of the
+/// members of an object with the same key only the last one is selected
+/// from, as it is the one kept when the object is built.
+class path_handler final : public handler
+{
+public:
+    explicit path_handler(const path_plan& plan);
+
+    bool on_null() override;
+    bool on_bool(bool value) override;
+    bool on_int(int64_t value) override;
+    bool on_double(double value) override;
+    bool on_string(std::string_view value) override;
+    bool on_object_begin() override;
+    bool on_key(std::string_view key) override;
+    bool on_object_end() override;
+    bool on_array_begin() override;
+    bool on_array_end() override;
+
+    /// @return The array of the values selected, which is moved out of the
+    ///         handler
+    json release();
+
+private:
+    /// Called before the events of every value, which assigns the value
+    /// its positions and starts the captures it needs
+    /// @return The offset of the positions of the value in m_positions
+    std::size_t begin_value(class_type type);
+
+    /// Called after the events of every value, which completes the
+    /// captures of the value
+    void end_value();
+
+    /// Starts building the current value, which is filtered by the segment
+    /// or selected from by it when it is complete
+    /// @param count The number of times the values selected are selected
+    void capture(std::size_t segment, bool filter, std::size_t count);
+
+    /// Called after the events of every member, which drops the values
+    /// selected from an earlier member with the same key
+    void end_member();
+
+private:
+    /// A position in the path matched by a value
+    struct position
+    {
+        /// The index of the segment applied next
+        std::size_t m_segment;
+
+        /// The number of ways the value matched the position, as recursive
+        /// descents may reach it through several of its ancestors
+        std::size_t m_count;
+    };
+
+    struct frame
+    {
+        /// The offset of the positions of the object or array in
+        /// m_positions
+        std::size_t m_positions;
+
+        bool m_array;
+
+        /// The index of the next element of an array
+        std::size_t m_next_index;
+
+        /// The key of the member being parsed, set by on_key()
+        std::string m_key;
+
+        /// The first slot of the member being parsed
+        std::size_t m_member_slots;
+
+        /// The slots of the members which selected values, by key
+        std::unordered_map<std::string, std::pair<std::size_t, std::size_t>>
+            m_members;
+    };
+
+    /// A value being built
+    struct capture_state
+    {
+        capture_state(const json::parse_options& options,
+                      std::error_code& error);
+
+        dom_builder m_builder;
+
+        /// The depth of the value, so it is complete when the stack is back
+        /// at that depth
+        std::size_t m_depth;
+
+        /// The slot of the results the value is selected into
+        std::size_t m_slot;
+
+        /// The segment applied to the value when it is complete, or the size
+        /// of the path if the value is selected itself
+        std::size_t m_segment;
+
+        /// Set if the value is filtered by m_segment rather than selected
+        /// from
+        bool m_filter;
+    };
+
+    /// The values selected by a value or capture, in the order they start
+    struct slot
+    {
+        /// The value selected, or an array of the values selected
+        json m_value;
+
+        /// Set if m_value holds an array of values selected
+        bool m_many;
+
+        /// The number of times the values are selected, or zero if they were
+        /// selected from a member replaced by a later one with the same key
+        std::size_t m_count;
+    };
+
+    const std::vector<path_segment>& m_segments;
+
+    const json::parse_options m_options;
+    std::error_code m_error;
+
+    /// The positions of the objects and arrays being parsed, followed by
+    /// the positions of the current value
+    std::vector<position> m_positions;
+
+    /// The objects and arrays being parsed, innermost last
+    std::vector<frame> m_stack;
+
+    /// The values being built, innermost last
+    std::vector<std::unique_ptr<capture_state>> m_captures;
+
+    std::vector<slot> m_slots;
+};
+}
+}
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "pointer.hpp"
+#include "number.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+std::size_t pointer_index(std::string_view token)
+{
+    if (token.empty() || (token[0] == '0' && token.size() > 1))
+        return no_index;
+
+    std::size_t index = 0;
+    for (char c : token)
+    {
+        if (!is_digit(c))
+            return no_index;
+
+        std::size_t digit = std::size_t(c - '0');
+        if (index > (no_index - 1 - digit) / 10)
+            return no_index;
+        index = index * 10 + digit;
+    }
+    return index;
+}
+
+bool unescape_pointer_token(std::string_view token, std::string& output)
+{
+    output.clear();
+    for (std::size_t i = 0; i < token.size(); ++i)
+    {
+        if (token[i] != '~')
+        {
+            output.push_back(token[i]);
+            continue;
+        }
+
+        if (i + 1 == token.size())
+            return false;
+
+        ++i;
+        if (token[i] == '0')
+            output.push_back('~');
+        else if (token[i] == '1')
+            output.push_back('/');
+        else
+            return false;
+    }
+    return true;
+}
+}
+}
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../error.hpp"
+#include "../version.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The index of a reference token which is not an array index
+constexpr std::size_t no_index = std::numeric_limits<std::size_t>::max();
+
+/// @return The array index written in the reference token, or no_index if
+///         it is not an array index. Indices with leading zeros and "-",
+///         the element after the last one, are not array indices.
+std::size_t pointer_index(std::string_view token);
+
+/// Replaces "~1" with "/" and "~0" with "~" in the reference token.
+/// @return False if the token contains any other "~" sequence
+bool unescape_pointer_token(std::string_view token, std::string& output);
+
+/// Splits an RFC 6901 JSON pointer into its reference tokens and calls
+/// function(key, index) for each of them, with the unescaped token and its
+/// array index as returned by pointer_index(). The key may refer to buffer,
+/// which is reused for the tokens with escape sequences.
+template <class Function>
+void for_each_pointer_token(std::string_view pointer, std::string& buffer,
+                            std::error_code& error, Function&& function)
+{
+    assert(!error);
+
+    // The empty pointer refers to the whole document
+    if (pointer.empty())
+        return;
+
+    if (pointer[0] != '/')
+    {
+        error = bourne::error::pointer_invalid_syntax;
+        return;
+    }
+
+    std::size_t begin = 1;
+    while (true)
+    {
+        std::size_t end = pointer.find('/', begin);
+        if (end == std::string_view::npos)
+            end = pointer.size();
+
+        std::string_view token = pointer.substr(begin, end - begin);
+        if (token.find('~') != std::string_view::npos)
+        {
+            if (!unescape_pointer_token(token, buffer))
+            {
+                error = bourne::error::pointer_invalid_syntax;
+                return;
+            }
+            token = buffer;
+        }
+
+        function(token, pointer_index(token));
+
+        if (end == pointer.size())
+            return;
+        begin = end + 1;
+    }
+}
+}
+}
+}
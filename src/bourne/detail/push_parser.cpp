@@ -0,0 +1,335 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "push_parser.hpp"
+#include "../error.hpp"
+#include "basic_parser.hpp"
+#include "number.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+push_parser::push_parser(handler& handler, std::error_code& error) :
+    m_handler(handler), m_error(error)
+{
+}
+
+void push_parser::feed(const char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    while (offset < size && !m_error)
+    {
+        switch (m_state)
+        {
+        case state::string:
+            offset += parse_string(data + offset, size - offset);
+            break;
+        case state::number:
+            offset += parse_number(data + offset, size - offset);
+            break;
+        case state::literal:
+            offset += parse_literal(data + offset, size - offset);
+            break;
+        default:
+            parse_structure(data[offset++]);
+            break;
+        }
+    }
+}
+
+void push_parser::finish()
+{
+    if (m_error)
+        return;
+
+    switch (m_state)
+    {
+    case state::complete:
+        return;
+    case state::string:
+    case state::number:
+    case state::literal:
+        end_token(true);
+        if (m_error || m_state == state::complete)
+            return;
+        break;
+    default:
+        break;
+    }
+
+    // When parsing the whole input at once the parser reads a zero at the
+    // end of the input.
+    parse_structure('\0');
+}
+
+bool push_parser::is_complete() const
+{
+    return !m_error && m_state == state::complete;
+}
+
+void push_parser::parse_structure(char c)
+{
+    if (is_white_space(c))
+        return;
+
+    switch (m_state)
+    {
+    case state::value:
+        begin_value(c);
+        return;
+    case state::object_first_key:
+        if (c == '}')
+        {
+            end_container(m_handler.on_object_end());
+            return;
+        }
+        [[fallthrough]];
+    case state::object_key:
+        if (c != '\"')
+        {
+            m_error = bourne::error::parse_next_unexpected_char;
+            return;
+        }
+        begin_token(state::string, c);
+        m_is_key = true;
+        return;
+    case state::colon:
+        if (c != ':')
+        {
+            m_error = bourne::error::parse_object_expected_colon;
+            return;
+        }
+        m_state = state::value;
+        return;
+    case state::object_next:
+        if (c == ',')
+        {
+            m_state = state::object_key;
+        }
+        else if (c == '}')
+        {
+            end_container(m_handler.on_object_end());
+        }
+        else
+        {
+            m_error = bourne::error::parse_object_expected_comma;
+        }
+        return;
+    case state::array_first_value:
+        if (c == ']')
+        {
+            end_container(m_handler.on_array_end());
+            return;
+        }
+        begin_value(c);
+        return;
+    case state::array_next:
+        if (c == ',')
+        {
+            m_state = state::value;
+        }
+        else if (c == ']')
+        {
+            end_container(m_handler.on_array_end());
+        }
+        else
+        {
+            m_error =
+                bourne::error::parse_array_expected_comma_or_closing_bracket;
+        }
+        return;
+    case state::complete:
+        m_error = bourne::error::parse_found_multiple_unstructured_elements;
+        return;
+    default:
+        assert(0 && "Tokens are not parsed as structure");
+        return;
+    }
+}
+
+void push_parser::begin_value(char c)
+{
+    switch (c)
+    {
+    case '{':
+        handle(m_handler.on_object_begin());
+        m_stack.push_back(true);
+        m_state = state::object_first_key;
+        return;
+    case '[':
+        handle(m_handler.on_array_begin());
+        m_stack.push_back(false);
+        m_state = state::array_first_value;
+        return;
+    case '\"':
+        begin_token(state::string, c);
+        return;
+    case 't':
+    case 'n':
+        m_literal_size = 4;
+        begin_token(state::literal, c);
+        return;
+    case 'f':
+        m_literal_size = 5;
+        begin_token(state::literal, c);
+        return;
+    default:
+        if ((c <= '9' && c >= '0') || c == '-')
+        {
+            begin_token(state::number, c);
+            return;
+        }
+    }
+    m_error = bourne::error::parse_next_unexpected_char;
+}
+
+void push_parser::begin_token(state token, char c)
+{
+    m_state = token;
+    m_token.assign(1, c);
+    m_is_key = false;
+    m_string_state = string_state::normal;
+}
+
+std::size_t push_parser::parse_string(const char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    while (offset < size)
+    {
+        if (m_string_state == string_state::normal)
+        {
+            auto run = find_quote_or_backslash(data + offset, size - offset);
+            m_token.append(data + offset, run);
+            offset += run;
+            if (offset == size)
+                break;
+        }
+
+        char c = data[offset++];
+        m_token += c;
+        switch (m_string_state)
+        {
+        case string_state::normal:
+            if (c == '\"')
+            {
+                end_token(false);
+                return offset;
+            }
+            m_string_state = string_state::escape;
+            break;
+        case string_state::escape:
+            m_string_state =
+                c == 'u' ? string_state::unicode : string_state::normal;
+            m_unicode_digits = 0;
+            break;
+        case string_state::unicode:
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+                  (c >= 'A' && c <= 'F')))
+            {
+                // Let the parser report the invalid escape
+                end_token(false);
+                return offset;
+            }
+            if (++m_unicode_digits == 4)
+                m_string_state = string_state::normal;
+            break;
+        }
+    }
+    return offset;
+}
+
+std::size_t push_parser::parse_number(const char* data, std::size_t size)
+{
+    // Collects the bytes which may be part of a number, and the byte
+    // following them, which is all basic_parser reads for the number.
+    std::size_t offset = 0;
+    while (offset < size)
+    {
+        char c = data[offset++];
+        m_token += c;
+        if (!is_digit(c) && c != '-' && c != '+' && c != '.' && c != 'e' &&
+            c != 'E')
+        {
+            end_token(false);
+            return offset;
+        }
+    }
+    return offset;
+}
+
+std::size_t push_parser::parse_literal(const char* data, std::size_t size)
+{
+    assert(m_token.size() < m_literal_size);
+    std::size_t count = std::min(size, m_literal_size - m_token.size());
+    m_token.append(data, count);
+    if (m_token.size() == m_literal_size)
+        end_token(false);
+    return count;
+}
+
+void push_parser::end_token(bool end_of_input)
+{
+    basic_parser<handler> parser(m_token, m_handler, m_error, nullptr);
+    std::size_t size = m_is_key ? parser.parse_key() : parser.parse_value();
+    if (m_error)
+        return;
+
+    if (m_is_key)
+    {
+        m_state = state::colon;
+    }
+    else
+    {
+        end_value();
+    }
+
+    if (end_of_input)
+        return;
+
+    // A number ends with the byte following it, which is parsed again
+    std::string rest(m_token, size);
+    m_token.clear();
+    feed(rest.data(), rest.size());
+}
+
+void push_parser::end_container(bool keep_going)
+{
+    assert(!m_stack.empty());
+    m_stack.pop_back();
+    handle(keep_going);
+    end_value();
+}
+
+void push_parser::end_value()
+{
+    if (m_stack.empty())
+    {
+        m_state = state::complete;
+    }
+    else if (m_stack.back())
+    {
+        m_state = state::object_next;
+    }
+    else
+    {
+        m_state = state::array_next;
+    }
+}
+
+void push_parser::handle(bool keep_going)
+{
+    if (!keep_going && !m_error)
+        m_error = bourne::error::parse_stopped_by_handler;
+}
+}
+}
+}
@@ -0,0 +1,126 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../handler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Resumable json parser which is fed the input in chunks.
+///
+/// The structure of the document is tracked by a state machine with an
+/// explicit stack, so parsing can stop at the end of any chunk. Strings,
+/// numbers and literals are collected in a token buffer until they are
+/// complete and then parsed by basic_parser, so the values and errors
+/// reported are the same as when parsing the whole input at once.
+class push_parser
+{
+public:
+    /// @param error Set when the input is invalid or the handler stops
+    ///        parsing.
+    push_parser(handler& handler, std::error_code& error);
+
+    /// Parses the next chunk of the input
+    void feed(const char* data, std::size_t size);
+
+    /// Completes parsing at the end of the input
+    void finish();
+
+    /// @return True when a complete value has been parsed, after which only
+    ///         white space may follow.
+    bool is_complete() const;
+
+private:
+    enum class state
+    {
+        value,
+        object_first_key,
+        object_key,
+        colon,
+        object_next,
+        array_first_value,
+        array_next,
+        complete,
+        string,
+        number,
+        literal
+    };
+
+    enum class string_state
+    {
+        normal,
+        escape,
+        unicode
+    };
+
+    /// Handles one byte outside of strings, numbers and literals
+    void parse_structure(char c);
+
+    /// Handles the first byte of a value
+    void begin_value(char c);
+
+    /// Starts collecting a string, number or literal
+    void begin_token(state token, char c);
+
+    /// Collects the bytes of a string.
+    /// @return The number of bytes consumed
+    std::size_t parse_string(const char* data, std::size_t size);
+
+    /// Collects the bytes of a number.
+    /// @return The number of bytes consumed
+    std::size_t parse_number(const char* data, std::size_t size);
+
+    /// Collects the bytes of a literal.
+    /// @return The number of bytes consumed
+    std::size_t parse_literal(const char* data, std::size_t size);
+
+    /// Parses the collected token and continues with the bytes following it
+    void end_token(bool end_of_input);
+
+    /// Ends the innermost object or array
+    void end_container(bool keep_going);
+
+    /// Sets the state following a complete value
+    void end_value();
+
+    /// Stops parsing if a handler callback returned false
+    void handle(bool keep_going);
+
+private:
+    handler& m_handler;
+    std::error_code& m_error;
+    state m_state = state::value;
+
+    /// The open containers, true for objects and false for arrays
+    std::vector<bool> m_stack;
+
+    /// The bytes of the string, number or literal being collected
+    std::string m_token;
+
+    /// True if the string being collected is an object key
+    bool m_is_key = false;
+
+    string_state m_string_state = string_state::normal;
+
+    /// The number of hex digits seen of a unicode escape
+    uint32_t m_unicode_digits = 0;
+
+    /// The length of the literal being collected
+    std::size_t m_literal_size = 0;
+};
+}
+}
+}
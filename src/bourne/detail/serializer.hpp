@@ -0,0 +1,333 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../class_type.hpp"
+#include "../json.hpp"
+#include "number.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// Serializer sink which appends to a std::string
+class string_sink
+{
+public:
+    explicit string_sink(std::string& string) : m_string(string)
+    {
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        m_string.append(data, size);
+    }
+
+private:
+    std::string& m_string;
+};
+
+/// Serializer sink which writes to a std::ostream
+class ostream_sink
+{
+public:
+    explicit ostream_sink(std::ostream& stream) : m_stream(stream)
+    {
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        m_stream.write(data, size);
+    }
+
+private:
+    std::ostream& m_stream;
+};
+
+/// Serializer sink which passes the data to a function
+class function_sink
+{
+public:
+    explicit function_sink(const json::write_function& function) :
+        m_function(function)
+    {
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        m_function(data, size);
+    }
+
+private:
+    const json::write_function& m_function;
+};
+
+/// Serializer output which collects the many small writes of the
+/// serializer in a fixed buffer, which is written to the sink when full.
+/// The sink must have the member function write(const char*, std::size_t).
+///
+/// The buffer is not flushed on destruction, since the sink may throw, so
+/// flush() must be called when done.
+template <class Sink>
+class buffered_output
+{
+public:
+    /// The size of the buffer
+    static constexpr std::size_t capacity = 4096;
+
+    explicit buffered_output(Sink& sink) : m_sink(sink)
+    {
+    }
+
+    buffered_output(const buffered_output&) = delete;
+    buffered_output& operator=(const buffered_output&) = delete;
+
+    void write(const char* data, std::size_t size)
+    {
+        if (size > capacity - m_size)
+        {
+            flush();
+
+            // Large writes bypass the buffer
+            if (size > capacity)
+            {
+                m_sink.write(data, size);
+                return;
+            }
+        }
+        std::memcpy(m_buffer + m_size, data, size);
+        m_size += size;
+    }
+
+    void write(char c)
+    {
+        if (m_size == capacity)
+            flush();
+        m_buffer[m_size++] = c;
+    }
+
+    /// Writes the buffered bytes to the sink
+    void flush()
+    {
+        if (m_size == 0)
+            return;
+        m_sink.write(m_buffer, m_size);
+        m_size = 0;
+    }
+
+private:
+    Sink& m_sink;
+    std::size_t m_size = 0;
+    char m_buffer[capacity];
+};
+
+/// Returns the escape sequence of a character, or nullptr if the character
+/// is written as it is
+inline const char* escape_sequence(char c)
+{
+    switch (c)
+    {
+    case '\"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\b':
+        return "\\b";
+    case '\f':
+        return "\\f";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        return nullptr;
+    }
+}
+
+/// Writes the escaped form of a string, without the surrounding quotes.
+/// Escape sequences for unicode characters are kept as they are, since the
+/// parser stores them unchanged.
+template <class Output>
+void write_escaped(std::string_view string, Output& output)
+{
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < string.size(); ++i)
+    {
+        // Only quotes, backslashes and control characters are escaped
+        const char c = string[i];
+        if (c != '\"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20)
+            continue;
+
+        const char* escape = escape_sequence(c);
+        if (escape == nullptr)
+            continue;
+        if (c == '\\' && i + 1 < string.size() && string[i + 1] == 'u')
+            escape = "\\";
+
+        // Write the bytes up to the escaped one in one go
+        output.write(string.data() + run, i - run);
+        output.write(escape, std::char_traits<char>::length(escape));
+        run = i + 1;
+    }
+    output.write(string.data() + run, string.size() - run);
+}
+
+/// Writes json values to an output, either indented as json::dump() or
+/// compact as json::dump_min(). All values are written directly to the
+/// output, without building intermediate strings.
+///
+/// The output must have the member functions write(const char*, std::size_t)
+/// and write(char).
+template <class Output>
+class serializer
+{
+public:
+    /// Creates a serializer writing the compact format
+    explicit serializer(Output& output) : m_output(output)
+    {
+    }
+
+    /// Creates a serializer writing the indented format.
+    /// @param depth The indentation level of the members of the value
+    /// @param tab The indentation of a single level
+    serializer(Output& output, uint32_t depth, std::string_view tab) :
+        m_output(output), m_indented(true), m_depth(depth), m_tab(tab)
+    {
+    }
+
+    /// Writes the value
+    void write(const json& value)
+    {
+        write_value(value, m_depth);
+    }
+
+private:
+    void write_value(const json& value, uint32_t depth)
+    {
+        switch (value.json_type())
+        {
+        case class_type::null:
+            write_text("null");
+            return;
+        case class_type::object:
+            write_object(value, depth);
+            return;
+        case class_type::array:
+            write_array(value, depth);
+            return;
+        case class_type::string:
+            write_string(value.string_value());
+            return;
+        case class_type::floating:
+        {
+            char buffer[max_formatted_size];
+            char* end = format_double(value.internal().m_float, buffer);
+            m_output.write(buffer, end - buffer);
+            return;
+        }
+        case class_type::integral:
+        {
+            char buffer[max_formatted_size];
+            char* end = format_int(value.internal().m_int, buffer);
+            m_output.write(buffer, end - buffer);
+            return;
+        }
+        case class_type::boolean:
+            write_text(value.internal().m_bool ? "true" : "false");
+            return;
+        }
+    }
+
+    void write_object(const json& value, uint32_t depth)
+    {
+        m_output.write('{');
+        if (m_indented)
+            m_output.write('\n');
+
+        bool first = true;
+        for (const auto& member : *value.internal().m_map)
+        {
+            if (!first)
+                write_text(m_indented ? ",\n" : ",");
+            first = false;
+
+            if (m_indented)
+                write_indent(depth);
+            write_string(member.first);
+            write_text(m_indented ? " : " : ":");
+            write_value(member.second, depth + 1);
+        }
+
+        if (m_indented)
+        {
+            m_output.write('\n');
+            write_indent(depth == 0 ? 0 : depth - 1);
+        }
+        m_output.write('}');
+    }
+
+    void write_array(const json& value, uint32_t depth)
+    {
+        m_output.write('[');
+        bool first = true;
+        for (const auto& element : *value.internal().m_array)
+        {
+            if (!first)
+                write_text(m_indented ? ", " : ",");
+            first = false;
+            write_value(element, depth + 1);
+        }
+        m_output.write(']');
+    }
+
+    void write_string(std::string_view string)
+    {
+        m_output.write('\"');
+        write_escaped(string, m_output);
+        m_output.write('\"');
+    }
+
+    void write_indent(uint32_t depth)
+    {
+        // The indentation is built once for the deepest level seen and
+        // written as a prefix of it.
+        const std::size_t size = depth * m_tab.size();
+        while (m_indent.size() < size)
+        {
+            m_indent.append(m_tab.data(), m_tab.size());
+        }
+        m_output.write(m_indent.data(), size);
+    }
+
+    void write_text(std::string_view text)
+    {
+        m_output.write(text.data(), text.size());
+    }
+
+private:
+    Output& m_output;
+    const bool m_indented = false;
+    const uint32_t m_depth = 0;
+    const std::string_view m_tab;
+
+    /// The tab repeated for the deepest indentation written so far
+    std::string m_indent;
+};
+}
+}
+}
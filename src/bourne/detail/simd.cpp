@@ -0,0 +1,323 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define BOURNE_SIMD_X86
+#include <immintrin.h>
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOURNE_SIMD_SSE2
+#endif
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define BOURNE_SIMD_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BOURNE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BOURNE_TARGET_AVX2
+#else
+#define BOURNE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+block_masks classify_scalar(const char* block)
+{
+    block_masks masks{0, 0, 0, 0};
+    for (std::size_t i = 0; i < block_size; ++i)
+    {
+        const uint64_t bit = uint64_t{1} << i;
+        switch (block[i])
+        {
+        case '"':
+            masks.quote |= bit;
+            break;
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            masks.structural |= bit;
+            break;
+        default:
+            if (is_white_space(block[i]))
+                masks.white_space |= bit;
+            break;
+        }
+    }
+    return masks;
+}
+
+#if defined(BOURNE_SIMD_SSE2)
+block_masks classify_sse2(const char* block)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i control_range = _mm_set1_epi8('\r' - '\t');
+
+    block_masks masks{0, 0, 0, 0};
+    for (std::size_t i = 0; i < block_size; i += 16)
+    {
+        const __m128i in =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+
+        // '\t' to '\r' is a contiguous range, so an unsigned compare of the
+        // distance to '\t' against the size of the range finds all of them.
+        const __m128i distance = _mm_sub_epi8(in, tab);
+        const __m128i control = _mm_cmpeq_epi8(
+            _mm_min_epu8(distance, control_range), distance);
+        const __m128i white_space =
+            _mm_or_si128(_mm_cmpeq_epi8(in, space), control);
+
+        __m128i structural = _mm_cmpeq_epi8(in, _mm_set1_epi8('{'));
+        structural = _mm_or_si128(structural,
+                                  _mm_cmpeq_epi8(in, _mm_set1_epi8('}')));
+        structural = _mm_or_si128(structural,
+                                  _mm_cmpeq_epi8(in, _mm_set1_epi8('[')));
+        structural = _mm_or_si128(structural,
+                                  _mm_cmpeq_epi8(in, _mm_set1_epi8(']')));
+        structural = _mm_or_si128(structural,
+                                  _mm_cmpeq_epi8(in, _mm_set1_epi8(':')));
+        structural = _mm_or_si128(structural,
+                                  _mm_cmpeq_epi8(in, _mm_set1_epi8(',')));
+
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(
+                           _mm_cmpeq_epi8(in, quote))))
+                       << i;
+        masks.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(
+                               _mm_cmpeq_epi8(in, backslash))))
+                           << i;
+        masks.white_space |=
+            uint64_t(uint16_t(_mm_movemask_epi8(white_space))) << i;
+        masks.structural |= uint64_t(uint16_t(_mm_movemask_epi8(structural)))
+                            << i;
+    }
+    return masks;
+}
+#endif
+
+#if defined(BOURNE_SIMD_AVX2)
+BOURNE_TARGET_AVX2 block_masks classify_avx2(const char* block)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i control_range = _mm256_set1_epi8('\r' - '\t');
+
+    block_masks masks{0, 0, 0, 0};
+    for (std::size_t i = 0; i < block_size; i += 32)
+    {
+        const __m256i in =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+
+        const __m256i distance = _mm256_sub_epi8(in, tab);
+        const __m256i control = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(distance, control_range), distance);
+        const __m256i white_space =
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, space), control);
+
+        __m256i structural = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('{'));
+        structural = _mm256_or_si256(
+            structural, _mm256_cmpeq_epi8(in, _mm256_set1_epi8('}')));
+        structural = _mm256_or_si256(
+            structural, _mm256_cmpeq_epi8(in, _mm256_set1_epi8('[')));
+        structural = _mm256_or_si256(
+            structural, _mm256_cmpeq_epi8(in, _mm256_set1_epi8(']')));
+        structural = _mm256_or_si256(
+            structural, _mm256_cmpeq_epi8(in, _mm256_set1_epi8(':')));
+        structural = _mm256_or_si256(
+            structural, _mm256_cmpeq_epi8(in, _mm256_set1_epi8(',')));
+
+        masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(
+                           _mm256_cmpeq_epi8(in, quote))))
+                       << i;
+        masks.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(
+                               _mm256_cmpeq_epi8(in, backslash))))
+                           << i;
+        masks.white_space |=
+            uint64_t(uint32_t(_mm256_movemask_epi8(white_space))) << i;
+        masks.structural |=
+            uint64_t(uint32_t(_mm256_movemask_epi8(structural))) << i;
+    }
+    return masks;
+}
+
+bool cpu_supports_avx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX2 requires the OS to save the YMM registers (OSXSAVE and XCR0)
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(BOURNE_SIMD_NEON)
+uint64_t to_bitmask(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2,
+                    uint8x16_t m3)
+{
+    // NEON has no movemask, so weight each byte by its bit position and add
+    // neighbouring lanes together until each 16 byte chunk is 16 bits.
+    const uint8x16_t weights = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20,
+                                0x40, 0x80, 0x01, 0x02, 0x04, 0x08,
+                                0x10, 0x20, 0x40, 0x80};
+    uint8x16_t sum0 =
+        vpaddq_u8(vandq_u8(m0, weights), vandq_u8(m1, weights));
+    uint8x16_t sum1 =
+        vpaddq_u8(vandq_u8(m2, weights), vandq_u8(m3, weights));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+block_masks classify_neon(const char* block)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(block);
+    uint8x16_t quote[4];
+    uint8x16_t backslash[4];
+    uint8x16_t white_space[4];
+    uint8x16_t structural[4];
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        const uint8x16_t in = vld1q_u8(data + i * 16);
+        quote[i] = vceqq_u8(in, vdupq_n_u8('"'));
+        backslash[i] = vceqq_u8(in, vdupq_n_u8('\\'));
+        white_space[i] =
+            vorrq_u8(vceqq_u8(in, vdupq_n_u8(' ')),
+                     vcleq_u8(vsubq_u8(in, vdupq_n_u8('\t')),
+                              vdupq_n_u8('\r' - '\t')));
+
+        uint8x16_t s = vceqq_u8(in, vdupq_n_u8('{'));
+        s = vorrq_u8(s, vceqq_u8(in, vdupq_n_u8('}')));
+        s = vorrq_u8(s, vceqq_u8(in, vdupq_n_u8('[')));
+        s = vorrq_u8(s, vceqq_u8(in, vdupq_n_u8(']')));
+        s = vorrq_u8(s, vceqq_u8(in, vdupq_n_u8(':')));
+        s = vorrq_u8(s, vceqq_u8(in, vdupq_n_u8(',')));
+        structural[i] = s;
+    }
+
+    block_masks masks;
+    masks.quote = to_bitmask(quote[0], quote[1], quote[2], quote[3]);
+    masks.backslash =
+        to_bitmask(backslash[0], backslash[1], backslash[2], backslash[3]);
+    masks.white_space = to_bitmask(white_space[0], white_space[1],
+                                   white_space[2], white_space[3]);
+    masks.structural =
+        to_bitmask(structural[0], structural[1], structural[2], structural[3]);
+    return masks;
+}
+#endif
+}
+
+instruction_set best_instruction_set()
+{
+    static const instruction_set best = []
+    {
+#if defined(BOURNE_SIMD_AVX2)
+        if (cpu_supports_avx2())
+            return instruction_set::avx2;
+#endif
+#if defined(BOURNE_SIMD_SSE2)
+        return instruction_set::sse2;
+#elif defined(BOURNE_SIMD_NEON)
+        return instruction_set::neon;
+#else
+        return instruction_set::scalar;
+#endif
+    }();
+    return best;
+}
+
+classify_function classifier(instruction_set set)
+{
+    switch (set)
+    {
+    case instruction_set::scalar:
+        return classify_scalar;
+    case instruction_set::sse2:
+#if defined(BOURNE_SIMD_SSE2)
+        return classify_sse2;
+#else
+        return nullptr;
+#endif
+    case instruction_set::avx2:
+#if defined(BOURNE_SIMD_AVX2)
+        return cpu_supports_avx2() ? classify_avx2 : nullptr;
+#else
+        return nullptr;
+#endif
+    case instruction_set::neon:
+#if defined(BOURNE_SIMD_NEON)
+        return classify_neon;
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+block_masks classify_block(const char* block)
+{
+    static const classify_function classify =
+        classifier(best_instruction_set());
+    return classify(block);
+}
+
+std::size_t find_quote_or_backslash(const char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    for (; offset + block_size <= size; offset += block_size)
+    {
+        auto masks = classify_block(data + offset);
+        auto found = masks.quote | masks.backslash;
+        if (found != 0)
+            return offset + trailing_zeros(found);
+    }
+    for (; offset < size; ++offset)
+    {
+        if (data[offset] == '"' || data[offset] == '\\')
+            return offset;
+    }
+    return size;
+}
+}
+}
+}
@@ -0,0 +1,92 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The number of bytes classified by a single call to classify_block()
+constexpr std::size_t block_size = 64;
+
+/// The instruction sets which the block classifier can be built for.
+enum class instruction_set
+{
+    scalar,
+    sse2,
+    avx2,
+    neon
+};
+
+/// Bit masks describing a block of block_size bytes. Bit i of each mask is
+/// set if byte i of the block belongs to the given class.
+struct block_masks
+{
+    /// Bytes equal to '"'
+    uint64_t quote;
+
+    /// Bytes equal to '\\'
+    uint64_t backslash;
+
+    /// Bytes which are white space, see is_white_space()
+    uint64_t white_space;
+
+    /// Bytes equal to one of '{', '}', '[', ']', ':' or ','
+    uint64_t structural;
+};
+
+/// Signature of the block classifier functions
+using classify_function = block_masks (*)(const char* block);
+
+/// The white space characters skipped by the parser, this is the set matched
+/// by std::isspace in the "C" locale.
+inline bool is_white_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/// @return The number of trailing zero bits in mask, which must not be zero.
+inline uint32_t trailing_zeros(uint64_t mask)
+{
+    assert(mask != 0);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+/// @return The fastest instruction set supported by the running CPU.
+instruction_set best_instruction_set();
+
+/// @return The block classifier for the given instruction set or nullptr if
+///         it is not available in this build or on the running CPU.
+classify_function classifier(instruction_set set);
+
+/// Classifies the block_size bytes starting at block, using the best
+/// classifier available on the running CPU.
+block_masks classify_block(const char* block);
+
+/// @return The offset of the first '"' or '\\' in [data, data + size) or size
+///         if there is none.
+std::size_t find_quote_or_backslash(const char* data, std::size_t size);
+}
+}
+}
@@ -0,0 +1,173 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "structural_index.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// @return The mask of the bytes escaped by a backslash. A backslash escapes
+///         the byte following it, unless it is escaped itself. The carry is
+///         set if the last byte of the block escapes the first byte of the
+///         next block.
+uint64_t find_escaped(uint64_t backslash, bool& carry)
+{
+    uint64_t escaped = carry ? 1 : 0;
+    carry = false;
+
+    // Backslashes are rare, so visiting them one at a time is cheap.
+    backslash &= ~escaped;
+    while (backslash != 0)
+    {
+        auto bit = trailing_zeros(backslash);
+        if (bit == 63)
+        {
+            carry = true;
+            break;
+        }
+        escaped |= uint64_t{2} << bit;
+        backslash &= ~(uint64_t{3} << bit);
+    }
+    return escaped;
+}
+
+/// @return A mask where bit i is the xor of the bits 0 to i of mask.
+uint64_t prefix_xor(uint64_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+}
+
+structural_index::structural_index(const char* data, std::size_t size) :
+    structural_index(data, size, nullptr)
+{
+}
+
+structural_index::structural_index(const char* data, std::size_t size,
+                                   classify_function classify)
+{
+    assert(size <= max_size);
+    build(data, size, classify);
+}
+
+void structural_index::build(const char* data, std::size_t size,
+                             classify_function classify)
+{
+    m_offsets.clear();
+    m_offsets.reserve(size / 4 + 1);
+
+    bool escaped_carry = false;
+
+    // All ones if the previous block ended inside a string
+    uint64_t in_string_carry = 0;
+
+    // Set if the previous byte was white space or structural, the start of
+    // the input counts as white space.
+    uint64_t separator_carry = 1;
+
+    for (std::size_t offset = 0; offset < size; offset += block_size)
+    {
+        const std::size_t remaining = size - offset;
+
+        // The last partial block is padded with white space
+        char padded[block_size];
+        const char* block = data + offset;
+        if (remaining < block_size)
+        {
+            std::memset(padded, ' ', block_size);
+            std::memcpy(padded, block, remaining);
+            block = padded;
+        }
+
+        const block_masks masks =
+            classify ? classify(block) : classify_block(block);
+
+        const uint64_t escaped = find_escaped(masks.backslash, escaped_carry);
+        const uint64_t quote = masks.quote & ~escaped;
+
+        // The bits from an opening quote up to, but not including, the
+        // closing quote.
+        const uint64_t in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry = uint64_t(int64_t(in_string) >> 63);
+
+        const uint64_t separator = masks.white_space | masks.structural;
+        const uint64_t follows_separator = (separator << 1) | separator_carry;
+        separator_carry = separator >> 63;
+
+        const uint64_t token_start = ~(separator | masks.quote) &
+                                     follows_separator & ~in_string;
+
+        uint64_t found = (masks.structural & ~in_string) |
+                         (quote & in_string) | token_start;
+
+        while (found != 0)
+        {
+            m_offsets.push_back(uint32_t(offset + trailing_zeros(found)));
+            found &= found - 1;
+        }
+    }
+
+    // The padding is white space or part of a string so it is never indexed,
+    // the size is added as a sentinel.
+    m_offsets.push_back(uint32_t(size));
+
+    count_elements(data);
+}
+
+void structural_index::count_elements(const char* data)
+{
+    m_container_sizes.clear();
+
+    // The containers not closed yet, as positions in m_container_sizes
+    std::vector<uint32_t> open;
+    bool empty = false;
+    for (std::size_t i = 0; i + 1 < m_offsets.size(); ++i)
+    {
+        const char c = data[m_offsets[i]];
+        switch (c)
+        {
+        case '[':
+        case '{':
+            open.push_back(uint32_t(m_container_sizes.size()));
+            m_container_sizes.push_back(0);
+            empty = true;
+            continue;
+        case ',':
+            if (!open.empty())
+                m_container_sizes[open.back()]++;
+            break;
+        case ']':
+        case '}':
+            // The last element is not followed by a comma
+            if (!open.empty())
+            {
+                if (!empty)
+                    m_container_sizes[open.back()]++;
+                open.pop_back();
+            }
+            break;
+        default:
+            break;
+        }
+        empty = false;
+    }
+}
+}
+}
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "simd.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The first stage of the two-stage parser. Finds the offset of every
+/// structural character ('{', '}', '[', ']', ':' and ','), every opening
+/// quote and the first byte of every other token outside of strings, 64 bytes
+/// at a time using the block classifier.
+///
+/// Since only white space is left out, the first entry at or after an offset
+/// which is outside of a string and points to white space is the next
+/// non-white space byte.
+class structural_index
+{
+public:
+    /// The largest input which can be indexed, since offsets are stored as
+    /// 32 bit integers to keep the index compact.
+    static constexpr std::size_t max_size =
+        std::numeric_limits<uint32_t>::max() - 1;
+
+    /// Builds the index of the given input using the best classifier
+    /// available on the running CPU.
+    structural_index(const char* data, std::size_t size);
+
+    /// Builds the index of the given input with a specific classifier.
+    structural_index(const char* data, std::size_t size,
+                     classify_function classify);
+
+    /// @return The offsets found, the last entry is always the size of the
+    ///         input.
+    const std::vector<uint32_t>& offsets() const
+    {
+        return m_offsets;
+    }
+
+    /// @return The number of elements of every array and members of every
+    ///         object, in the order the arrays and objects start in the
+    ///         input. The sizes are only hints if the input is invalid.
+    const std::vector<uint32_t>& container_sizes() const
+    {
+        return m_container_sizes;
+    }
+
+private:
+    void build(const char* data, std::size_t size, classify_function classify);
+
+    void count_elements(const char* data);
+
+private:
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_container_sizes;
+};
+}
+}
+}
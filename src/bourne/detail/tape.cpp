@@ -0,0 +1,276 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "tape.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+namespace
+{
+/// Writes the nodes of a value to a tape. Nodes are written to space
+/// allocated for them by their parent, and the strings and child tables
+/// they refer to are allocated at the end of the tape as they are written.
+class tape_writer
+{
+public:
+    tape_writer(std::vector<uint8_t>& output, std::error_code& error) :
+        m_output(output), m_error(error)
+    {
+    }
+
+    void write(const json& value)
+    {
+        // The offsets are relative to the start of the tape, which may be
+        // appended to an output holding other data
+        m_start = m_output.size();
+        const uint64_t header = allocate(tape_header_size);
+        std::memcpy(m_output.data() + m_start + header, tape_magic,
+                    sizeof(tape_magic));
+        write_little_endian(tape_version, 4,
+                            m_output.data() + m_start + header + 8);
+
+        write_node(value, allocate(tape_node_size));
+    }
+
+private:
+    /// @return The offset of the given number of bytes allocated at the end
+    ///         of the tape, aligned to 8 bytes
+    uint64_t allocate(std::size_t bytes)
+    {
+        const std::size_t end = m_output.size() - m_start;
+        const std::size_t offset = (end + 7) & ~std::size_t(7);
+        m_output.resize(m_start + offset + bytes);
+        return offset;
+    }
+
+    /// @return True if the size fits in a node, otherwise the error is set
+    bool fits(std::size_t size)
+    {
+        if (uint64_t(size) <= UINT32_MAX)
+            return true;
+        m_error = bourne::error::encode_too_large;
+        return false;
+    }
+
+    void store(uint64_t offset, class_type type, std::size_t size,
+               uint64_t payload)
+    {
+        assert(size <= UINT32_MAX);
+        uint8_t* node = m_output.data() + m_start + offset;
+        node[0] = uint8_t(type);
+        write_little_endian(size, 4, node + 4);
+        write_little_endian(payload, 8, node + 8);
+    }
+
+    void write_string(uint64_t offset, std::string_view string)
+    {
+        if (!fits(string.size()))
+            return;
+
+        if (string.size() <= tape_inline_string)
+        {
+            store(offset, class_type::string, string.size(), 0);
+            std::copy(string.begin(), string.end(),
+                      m_output.begin() + m_start + offset + 8);
+            return;
+        }
+
+        const uint64_t characters = allocate(string.size());
+        std::copy(string.begin(), string.end(),
+                  m_output.begin() + m_start + characters);
+        store(offset, class_type::string, string.size(), characters);
+    }
+
+    void write_node(const json& value, uint64_t offset)
+    {
+        // The tape is discarded once a value does not fit
+        if (m_error)
+            return;
+
+        switch (value.json_type())
+        {
+        case class_type::null:
+            store(offset, class_type::null, 0, 0);
+            return;
+        case class_type::boolean:
+            store(offset, class_type::boolean, 0, value.to_bool());
+            return;
+        case class_type::integral:
+            store(offset, class_type::integral, 0, uint64_t(value.to_int()));
+            return;
+        case class_type::floating:
+            store(offset, class_type::floating, 0,
+                  double_bits(value.to_float()));
+            return;
+        case class_type::string:
+            write_string(offset, value.to_string_view());
+            return;
+        case class_type::array:
+        {
+            const std::size_t size = value.size();
+            if (!fits(size))
+                return;
+            const uint64_t table = allocate(size * tape_node_size);
+            store(offset, class_type::array, size, table);
+            uint64_t element = table;
+            for (const auto& item : value.array_range())
+            {
+                write_node(item, element);
+                element += tape_node_size;
+            }
+            return;
+        }
+        case class_type::object:
+        {
+            // The members of an object are kept sorted by their keys, so the
+            // keys are written in the order binary searches expect
+            const std::size_t size = value.size();
+            if (!fits(size))
+                return;
+            const uint64_t table = allocate(2 * size * tape_node_size);
+            store(offset, class_type::object, size, table);
+            uint64_t key = table;
+            uint64_t member = table + size * tape_node_size;
+            for (const auto& [name, item] : value.object_range())
+            {
+                write_string(key, name.view());
+                write_node(item, member);
+                key += tape_node_size;
+                member += tape_node_size;
+            }
+            return;
+        }
+        }
+        assert(0 && "Unknown class_type");
+    }
+
+private:
+    std::vector<uint8_t>& m_output;
+    std::error_code& m_error;
+
+    /// The position of the tape in the output
+    std::size_t m_start = 0;
+};
+}
+
+void write_tape(const json& value, std::vector<uint8_t>& output,
+                std::error_code& error)
+{
+    assert(!error);
+    const std::size_t start = output.size();
+    tape_writer(output, error).write(value);
+    if (error)
+        output.resize(start);
+}
+
+void tape_view::check(const uint8_t* data, std::size_t size,
+                      std::error_code& error)
+{
+    assert(!error);
+    if (size < tape_header_size + tape_node_size ||
+        std::memcmp(data, tape_magic, sizeof(tape_magic)) != 0 ||
+        read_little_endian(data + 8, 4) != tape_version)
+    {
+        error = bourne::error::decode_invalid_tape;
+    }
+}
+
+tape_node tape_view::node(uint64_t offset) const
+{
+    check_range(offset, tape_node_size);
+    const uint8_t* data = m_data + offset;
+    if (data[0] > uint8_t(class_type::boolean))
+        throw_invalid();
+
+    tape_node node;
+    node.m_type = class_type(data[0]);
+    node.m_size = uint32_t(read_little_endian(data + 4, 4));
+    node.m_payload = read_little_endian(data + 8, 8);
+    return node;
+}
+
+std::string_view tape_view::string(uint64_t offset,
+                                   const tape_node& node) const
+{
+    if (node.m_type != class_type::string)
+        throw_invalid();
+
+    const char* characters;
+    if (node.m_size <= tape_inline_string)
+    {
+        characters = reinterpret_cast<const char*>(m_data + offset + 8);
+    }
+    else
+    {
+        check_range(node.m_payload, node.m_size);
+        characters = reinterpret_cast<const char*>(m_data + node.m_payload);
+    }
+    return std::string_view(characters, node.m_size);
+}
+
+uint64_t tape_view::children(uint64_t offset, const tape_node& node) const
+{
+    assert(node.m_type == class_type::array ||
+           node.m_type == class_type::object);
+
+    // Children are stored after their parent, which rules out cycles
+    const uint64_t entries =
+        node.m_type == class_type::object ? 2 * uint64_t(node.m_size)
+                                          : node.m_size;
+    if (node.m_payload < offset + tape_node_size)
+        throw_invalid();
+    check_range(node.m_payload, entries * tape_node_size);
+    return node.m_payload;
+}
+
+uint64_t tape_view::find(uint64_t offset, const tape_node& node,
+                         std::string_view key) const
+{
+    const uint64_t table = children(offset, node);
+
+    // Binary search of the sorted keys
+    uint64_t first = 0;
+    uint64_t last = node.m_size;
+    while (first < last)
+    {
+        const uint64_t middle = first + (last - first) / 2;
+        const uint64_t position = table + middle * tape_node_size;
+        const int order = string(position, this->node(position)).compare(key);
+        if (order == 0)
+            return table + (node.m_size + middle) * tape_node_size;
+        if (order < 0)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return 0;
+}
+
+void tape_view::check_range(uint64_t offset, uint64_t bytes) const
+{
+    if (offset > m_size || bytes > m_size - offset)
+        throw_invalid();
+}
+
+void tape_view::throw_invalid()
+{
+    throw std::system_error(bourne::error::decode_invalid_tape);
+}
+}
+}
+}
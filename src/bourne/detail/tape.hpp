@@ -0,0 +1,195 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../class_type.hpp"
+#include "../error.hpp"
+#include "../json.hpp"
+#include "basic_parser.hpp"
+#include "binary.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// The binary tape format is a flat encoding of a json value which is read
+/// where it is, without decoding it first. It holds no pointers, only
+/// offsets from the start of the tape, so it can be written to a file and
+/// mapped into memory by another process.
+///
+/// The tape starts with a header of the magic bytes, the format version as
+/// a 32 bit integer and four reserved bytes, followed by the node of the
+/// root value. Every value is a node of 16 bytes:
+///
+///     byte 0      the class_type of the value
+///     bytes 4-7   the size of strings, arrays and objects
+///     bytes 8-15  the payload
+///
+/// The payload holds booleans, integers and the bits of doubles directly.
+/// Strings of up to 8 bytes are held in the payload as well, longer strings
+/// and the children of arrays and objects are stored later in the tape and
+/// the payload is their offset. The children of an array are a table of
+/// their nodes. The children of an object are a table of the nodes of its
+/// keys, sorted so they can be binary searched, followed by the nodes of
+/// the values in the same order.
+///
+/// Everything a node refers to is stored after the node, so a corrupt tape
+/// cannot make a reader loop. The nodes of a tape form a tree, so reading
+/// a value visits at most one node per node of the tape, which stops a
+/// corrupt tape whose containers share child tables from making a reader
+/// visit exponentially many nodes. All integers are little endian.
+constexpr uint8_t tape_magic[8] = {'b', 'o', 'u', 'r', 'n', 'e', 't', 'p'};
+constexpr uint32_t tape_version = 1;
+constexpr std::size_t tape_header_size = 16;
+constexpr std::size_t tape_node_size = 16;
+
+/// Strings of up to this size are held in the payload of their node
+constexpr std::size_t tape_inline_string = 8;
+
+/// Appends the value encoded as a binary tape. The tape is written in a
+/// single pass over the value. Sets bourne::error::encode_too_large and
+/// leaves the output as it was if a string, array or object of the value
+/// has more than UINT32_MAX bytes, elements or members.
+void write_tape(const json& value, std::vector<uint8_t>& output,
+                std::error_code& error);
+
+/// A decoded node of a tape
+struct tape_node
+{
+    class_type m_type;
+    uint32_t m_size;
+    uint64_t m_payload;
+};
+
+/// Read access to the nodes of a tape. Every offset is checked against the
+/// size of the tape, and reading outside it throws std::system_error with
+/// bourne::error::decode_invalid_tape, so corrupt tapes cannot make a
+/// reader access memory outside of it.
+class tape_view
+{
+public:
+    tape_view(const uint8_t* data, std::size_t size) :
+        m_data(data), m_size(size)
+    {
+    }
+
+    /// Checks the header of the tape, which is the only part checked up
+    /// front. Sets bourne::error::decode_invalid_tape if it is not a tape of
+    /// this version.
+    static void check(const uint8_t* data, std::size_t size,
+                      std::error_code& error);
+
+    /// @return The offset of the node of the root value
+    static uint64_t root()
+    {
+        return tape_header_size;
+    }
+
+    /// @return The node at the offset
+    tape_node node(uint64_t offset) const;
+
+    /// @return The characters of the string node at the offset
+    std::string_view string(uint64_t offset, const tape_node& node) const;
+
+    /// @return The offset of the table of child nodes of the array or
+    ///         object node at the offset
+    uint64_t children(uint64_t offset, const tape_node& node) const;
+
+    /// @return The offset of the node of the value with the key in the
+    ///         object node at the offset, or zero if there is none
+    uint64_t find(uint64_t offset, const tape_node& node,
+                  std::string_view key) const;
+
+    /// Reports the value at the offset and everything nested in it to the
+    /// handler, with the same callbacks as basic_parser
+    template <class Handler>
+    void report(uint64_t offset, Handler& handler) const
+    {
+        uint64_t nodes = m_size / tape_node_size;
+        report(offset, handler, nodes);
+    }
+
+private:
+    /// Reports the value at the offset, visiting at most the given number
+    /// of nodes, which is decremented by the nodes visited
+    template <class Handler>
+    void report(uint64_t offset, Handler& handler, uint64_t& nodes) const
+    {
+        if (nodes == 0)
+            throw_invalid();
+        --nodes;
+
+        const tape_node node = this->node(offset);
+        switch (node.m_type)
+        {
+        case class_type::null:
+            handler.on_null();
+            return;
+        case class_type::boolean:
+            handler.on_bool(node.m_payload != 0);
+            return;
+        case class_type::integral:
+            handler.on_int(int64_t(node.m_payload));
+            return;
+        case class_type::floating:
+            handler.on_double(bits_double(node.m_payload));
+            return;
+        case class_type::string:
+            handler.on_string(string(offset, node));
+            return;
+        case class_type::array:
+        {
+            const uint64_t table = children(offset, node);
+            handler.on_array_begin();
+            if constexpr (has_reserve<Handler>::value)
+                handler.reserve(node.m_size);
+            for (uint64_t i = 0; i < node.m_size; ++i)
+            {
+                report(table + i * tape_node_size, handler, nodes);
+            }
+            handler.on_array_end();
+            return;
+        }
+        case class_type::object:
+        {
+            const uint64_t table = children(offset, node);
+            const uint64_t values = table + node.m_size * tape_node_size;
+            handler.on_object_begin();
+            if constexpr (has_reserve<Handler>::value)
+                handler.reserve(node.m_size);
+            for (uint64_t i = 0; i < node.m_size; ++i)
+            {
+                const uint64_t key = table + i * tape_node_size;
+                handler.on_key(string(key, this->node(key)));
+                report(values + i * tape_node_size, handler, nodes);
+            }
+            handler.on_object_end();
+            return;
+        }
+        }
+    }
+
+    /// Throws if the bytes at the offset are not inside the tape
+    void check_range(uint64_t offset, uint64_t bytes) const;
+
+    /// Throws std::system_error with bourne::error::decode_invalid_tape
+    [[noreturn]] static void throw_invalid();
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+};
+}
+}
+}
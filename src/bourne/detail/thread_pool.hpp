@@ -0,0 +1,76 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+/// A fixed number of threads which run the tasks submitted to them in the
+/// order they were submitted.
+class thread_pool
+{
+public:
+    /// Starts the threads
+    explicit thread_pool(std::size_t threads);
+
+    /// Runs the tasks still queued and joins the threads
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// @return The number of threads of the pool
+    std::size_t size() const
+    {
+        return m_threads.size();
+    }
+
+    /// Queues the task to run on one of the threads.
+    /// @return The future result of the task, which also holds any exception
+    ///         thrown by it
+    template <class Task>
+    auto submit(Task task) -> std::future<std::invoke_result_t<Task>>
+    {
+        // Queued functions must be copyable, which a packaged_task is not
+        using result_type = std::invoke_result_t<Task>;
+        auto packaged = std::make_shared<std::packaged_task<result_type()>>(
+            std::move(task));
+        auto result = packaged->get_future();
+        push([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+private:
+    void push(std::function<void()> task);
+
+    void run();
+
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+}
+}
+}
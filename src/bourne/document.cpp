@@ -0,0 +1,144 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "document.hpp"
+
+#include "detail/mapped_file.hpp"
+#include "detail/parser.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+document::document() : m_arena(new detail::arena())
+{
+}
+
+document::document(document&& other) noexcept :
+    m_arena(std::move(other.m_arena)), m_root(std::move(other.m_root))
+{
+}
+
+document& document::operator=(document&& other) noexcept
+{
+    // The current root must be cleared before its arena is released
+    m_root = nullptr;
+    m_arena = std::move(other.m_arena);
+    m_root = std::move(other.m_root);
+    return *this;
+}
+
+document::~document()
+{
+}
+
+const json& document::root() const
+{
+    return m_root;
+}
+
+std::size_t document::arena_capacity() const
+{
+    return m_arena ? m_arena->capacity() : 0;
+}
+
+document document::parse(std::string_view input, std::error_code& error)
+{
+    return parse(input, json::parse_options{}, error);
+}
+
+document document::parse(std::string_view input,
+                         const json::parse_options& options,
+                         std::error_code& error)
+{
+    assert(!error);
+    document result;
+    if (options.borrow_strings && !input.empty())
+    {
+        // The strings are borrowed from a copy of the input kept in the
+        // arena, so the input does not have to outlive the document.
+        void* copy = result.m_arena->allocate(input.size(), 1);
+        std::memcpy(copy, input.data(), input.size());
+        input = std::string_view(static_cast<const char*>(copy), input.size());
+    }
+    result.m_root =
+        detail::parser::parse(input, options, result.m_arena.get(), error);
+    return result;
+}
+
+document document::parse(std::string_view input)
+{
+    return parse(input, json::parse_options{});
+}
+
+document document::parse(std::string_view input,
+                         const json::parse_options& options)
+{
+    std::error_code error;
+    auto result = parse(input, options, error);
+    throw_if_error(error);
+    return result;
+}
+
+document document::parse(const char* data, std::size_t size,
+                         std::error_code& error)
+{
+    return parse(std::string_view(data, size), error);
+}
+
+document document::parse(const char* data, std::size_t size,
+                         const json::parse_options& options,
+                         std::error_code& error)
+{
+    return parse(std::string_view(data, size), options, error);
+}
+
+document document::parse(const char* data, std::size_t size)
+{
+    return parse(std::string_view(data, size));
+}
+
+document document::parse(const char* data, std::size_t size,
+                         const json::parse_options& options)
+{
+    return parse(std::string_view(data, size), options);
+}
+
+document document::parse_file(const std::string& path, std::error_code& error)
+{
+    return parse_file(path, json::parse_options{}, error);
+}
+
+document document::parse_file(const std::string& path,
+                              const json::parse_options& options,
+                              std::error_code& error)
+{
+    assert(!error);
+    detail::mapped_file file(path, error);
+    if (error)
+        return document();
+    return parse(file.data(), options, error);
+}
+
+document document::parse_file(const std::string& path)
+{
+    return parse_file(path, json::parse_options{});
+}
+
+document document::parse_file(const std::string& path,
+                              const json::parse_options& options)
+{
+    std::error_code error;
+    auto result = parse_file(path, options, error);
+    throw_if_error(error);
+    return result;
+}
+}
+}
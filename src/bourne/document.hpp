@@ -0,0 +1,112 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "detail/arena.hpp"
+#include "error.hpp"
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+/// A parsed json document which owns the memory of its values.
+///
+/// All objects, arrays and strings of the document are allocated from a
+/// single arena while parsing, and the arena is released in one go when the
+/// document is destroyed. The values are read through the regular json API
+/// using root(). Copying a value out of the document creates a regular json
+/// value which does not depend on the document.
+///
+/// When parsed with the borrow_strings option the document keeps a copy of
+/// the input in the arena, which the strings without escape sequences refer
+/// to instead of being copied one by one.
+class document
+{
+public:
+    /// Creates an empty document with a null root value.
+    document();
+
+    /// Move constructor.
+    document(document&& other) noexcept;
+
+    /// Move assignment operator.
+    document& operator=(document&& other) noexcept;
+
+    /// Destructor
+    ~document();
+
+    /// Returns the root value of this document.
+    const json& root() const;
+
+    /// Returns the number of bytes reserved by the arena of this document.
+    std::size_t arena_capacity() const;
+
+    /// Parse a string as a json document.
+    static document parse(std::string_view input, std::error_code& error);
+
+    /// Parse a string as a json document with options.
+    static document parse(std::string_view input,
+                          const json::parse_options& options,
+                          std::error_code& error);
+
+    /// Parse a string as a json document.
+    static document parse(std::string_view input);
+
+    /// Parse a string as a json document with options.
+    static document parse(std::string_view input,
+                          const json::parse_options& options);
+
+    /// Parse the size bytes at data as a json document.
+    static document parse(const char* data, std::size_t size,
+                          std::error_code& error);
+
+    /// Parse the size bytes at data as a json document with options.
+    static document parse(const char* data, std::size_t size,
+                          const json::parse_options& options,
+                          std::error_code& error);
+
+    /// Parse the size bytes at data as a json document.
+    static document parse(const char* data, std::size_t size);
+
+    /// Parse the size bytes at data as a json document with options.
+    static document parse(const char* data, std::size_t size,
+                          const json::parse_options& options);
+
+    /// Parse the file at the path as a json document. The file is mapped
+    /// into memory and parsed where it is, see json::parse_file().
+    static document parse_file(const std::string& path,
+                               std::error_code& error);
+
+    /// Parse the file at the path as a json document with options. With
+    /// the borrow_strings option the document keeps a copy of the file.
+    static document parse_file(const std::string& path,
+                               const json::parse_options& options,
+                               std::error_code& error);
+
+    /// Parse the file at the path as a json document.
+    static document parse_file(const std::string& path);
+
+    /// Parse the file at the path as a json document with options.
+    static document parse_file(const std::string& path,
+                               const json::parse_options& options);
+
+private:
+    /// The arena must outlive the root value
+    std::unique_ptr<detail::arena> m_arena;
+
+    /// The root value allocated from the arena
+    json m_root;
+};
+}
+}
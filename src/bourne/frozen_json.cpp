@@ -0,0 +1,100 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "frozen_json.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace
+{
+/// The tape of a null value, shared by all snapshots created empty
+std::shared_ptr<const tape_document> null_document()
+{
+    static const auto document = std::make_shared<const tape_document>();
+    return document;
+}
+}
+
+frozen_json::frozen_json() : m_document(null_document())
+{
+}
+
+frozen_json::frozen_json(std::shared_ptr<const tape_document> document) :
+    m_document(std::move(document))
+{
+    assert(m_document);
+}
+
+tape_value frozen_json::root() const
+{
+    assert(m_document && "The snapshot has been moved from");
+    return m_document->root();
+}
+
+std::size_t frozen_json::size() const
+{
+    assert(m_document && "The snapshot has been moved from");
+    return m_document->size();
+}
+
+frozen_json frozen_json::freeze(const json& value)
+{
+    return frozen_json(std::make_shared<const tape_document>(
+        tape_document::from_json(value)));
+}
+
+atomic_frozen_json::atomic_frozen_json() : m_documents{null_document()}
+{
+}
+
+atomic_frozen_json::atomic_frozen_json(frozen_json snapshot) :
+    m_documents{std::move(snapshot.m_document)}
+{
+}
+
+frozen_json atomic_frozen_json::load() const
+{
+    // Entering the current slot is a single step, so a reader never waits
+    // for a writer or tries again
+    const uint32_t state = m_state.fetch_add(2);
+    const uint32_t current = state & 1;
+    frozen_json snapshot(m_documents[current]);
+    m_left[current].fetch_add(1);
+    return snapshot;
+}
+
+void atomic_frozen_json::store(frozen_json snapshot)
+{
+    exchange(std::move(snapshot));
+}
+
+frozen_json atomic_frozen_json::exchange(frozen_json snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_writer);
+    const uint32_t previous = m_state.load() & 1;
+    const uint32_t next = 1 - previous;
+
+    // No reader copies the other slot, as every reader which entered it had
+    // left when the last writer switched away from it
+    m_documents[next] = std::move(snapshot.m_document);
+    const uint32_t entered = m_state.exchange(next) >> 1;
+
+    // The counts wrap around, so they are compared without the bit of the
+    // slot which the count of entered readers lacks
+    const uint32_t count_mask = UINT32_MAX >> 1;
+    while ((m_left[previous].load() & count_mask) != entered)
+        std::this_thread::yield();
+    m_left[previous].store(0);
+    return frozen_json(std::move(m_documents[previous]));
+}
+}
+}
@@ -0,0 +1,131 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "json.hpp"
+#include "tape_document.hpp"
+#include "tape_value.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+class atomic_frozen_json;
+
+/// An immutable snapshot of a json value, which any number of threads may
+/// read at the same time.
+///
+/// The value is encoded as a binary tape when it is frozen, so the snapshot
+/// is a single block of memory and reading it never modifies it: members
+/// are found by a binary search of the sorted keys and elements by their
+/// index, without taking any locks.
+///
+///     auto snapshot = bourne::frozen_json::freeze(config);
+///     auto port = snapshot.root()["server"]["port"].to_int();
+///
+/// Copies of a snapshot share the same tape, which is released with the
+/// last copy. The values found through root() are valid as long as a copy
+/// of the snapshot is.
+class frozen_json
+{
+public:
+    /// Creates a snapshot of a null value.
+    frozen_json();
+
+    /// Returns the root value of this snapshot.
+    tape_value root() const;
+
+    /// Returns the size of the tape of this snapshot in bytes.
+    std::size_t size() const;
+
+    /// Returns a snapshot of the value.
+    static frozen_json freeze(const json& value);
+
+private:
+    friend class atomic_frozen_json;
+
+    explicit frozen_json(std::shared_ptr<const tape_document> document);
+
+private:
+    std::shared_ptr<const tape_document> m_document;
+};
+
+/// Holds the current snapshot of a value which is read by many threads and
+/// replaced by a writer, in the style of read-copy-update.
+///
+/// Readers load() the current snapshot and read it as long as they like,
+/// while a writer may store() a new snapshot at any time without waiting
+/// for them to be done reading. A replaced snapshot is released when the
+/// last reader holding it is done.
+///
+///     bourne::atomic_frozen_json current(
+///         bourne::frozen_json::freeze(config));
+///
+///     // Reader threads
+///     auto snapshot = current.load();
+///     auto port = snapshot.root()["server"]["port"].to_int();
+///
+///     // Writer thread
+///     current.store(bourne::frozen_json::freeze(new_config));
+///
+/// The snapshot is held in one of two slots. load() is wait-free: it enters
+/// the current slot with a single atomic increment, copies its snapshot and
+/// counts itself as having left the slot, in a fixed number of steps
+/// whatever the writers do. store() and exchange() put the new snapshot
+/// into the other slot, switch to it and then wait until every reader which
+/// entered the old slot has left it, which only takes as long as copying a
+/// reference counted pointer. Stores are serialized by a mutex, which
+/// readers never take. The lookups into a loaded snapshot take no locks at
+/// all, so readers should load the snapshot once per unit of work rather
+/// than once per lookup.
+class atomic_frozen_json
+{
+public:
+    /// Creates a holder of a snapshot of a null value.
+    atomic_frozen_json();
+
+    /// Creates a holder of the snapshot.
+    explicit atomic_frozen_json(frozen_json snapshot);
+
+    atomic_frozen_json(const atomic_frozen_json&) = delete;
+    atomic_frozen_json& operator=(const atomic_frozen_json&) = delete;
+
+    /// Returns the current snapshot.
+    frozen_json load() const;
+
+    /// Replaces the current snapshot.
+    void store(frozen_json snapshot);
+
+    /// Replaces the current snapshot and returns the one it replaced.
+    frozen_json exchange(frozen_json snapshot);
+
+private:
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "Loading a snapshot must not take locks");
+
+    /// The current snapshot, and the next one while it is stored
+    std::shared_ptr<const tape_document> m_documents[2];
+
+    /// The index of the slot of the current snapshot in the lowest bit, and
+    /// the number of readers which entered it since it became current in
+    /// the other bits
+    mutable std::atomic<uint32_t> m_state{0};
+
+    /// The number of readers which left each slot since it became current
+    mutable std::atomic<uint32_t> m_left[2] = {{0}, {0}};
+
+    /// Serializes the writers
+    std::mutex m_writer;
+};
+}
+}
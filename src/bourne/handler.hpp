@@ -0,0 +1,101 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+/// Interface for receiving a json document as a sequence of events instead
+/// of a json value, see json::parse(std::string_view, handler&,
+/// std::error_code&).
+///
+/// Every callback returns true to continue parsing or false to stop, in which
+/// case parsing fails with bourne::error::parse_stopped_by_handler. The
+/// default implementations ignore the event and continue.
+///
+/// Strings are passed as views which are only valid for the duration of the
+/// callback. Strings without escape sequences point directly into the input.
+class handler
+{
+public:
+    /// Destructor
+    virtual ~handler() = default;
+
+    /// Called for a null value
+    virtual bool on_null()
+    {
+        return true;
+    }
+
+    /// Called for a boolean value
+    virtual bool on_bool(bool value)
+    {
+        (void)value;
+        return true;
+    }
+
+    /// Called for an integral value
+    virtual bool on_int(int64_t value)
+    {
+        (void)value;
+        return true;
+    }
+
+    /// Called for a floating point value
+    virtual bool on_double(double value)
+    {
+        (void)value;
+        return true;
+    }
+
+    /// Called for a string value
+    virtual bool on_string(std::string_view value)
+    {
+        (void)value;
+        return true;
+    }
+
+    /// Called when an object starts, followed by on_key() and the value of
+    /// each member and finally on_object_end()
+    virtual bool on_object_begin()
+    {
+        return true;
+    }
+
+    /// Called with the key of an object member, before its value
+    virtual bool on_key(std::string_view key)
+    {
+        (void)key;
+        return true;
+    }
+
+    /// Called when an object ends
+    virtual bool on_object_end()
+    {
+        return true;
+    }
+
+    /// Called when an array starts, followed by the values of its elements
+    /// and finally on_array_end()
+    virtual bool on_array_begin()
+    {
+        return true;
+    }
+
+    /// Called when an array ends
+    virtual bool on_array_end()
+    {
+        return true;
+    }
+};
+}
+}
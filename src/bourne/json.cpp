@@ -6,13 +6,25 @@
 #include "json.hpp"
 
 #include "class_type.hpp"
+#include "compiled_pointer.hpp"
+#include "detail/cbor.hpp"
+#include "detail/dom_builder.hpp"
+#include "detail/fd_sink.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/msgpack.hpp"
+#include "detail/number.hpp"
 #include "detail/parser.hpp"
+#include "detail/pointer.hpp"
+#include "detail/serializer.hpp"
+#include "detail/tape.hpp"
+#include "detail/throw_if_error.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -21,69 +33,93 @@ namespace bourne
 {
 inline namespace STEINWURF_BOURNE_VERSION
 {
-json::json() : m_internal(), m_type(class_type::null)
+namespace
 {
+/// Writes the value to the sink in the compact format, through a fixed size
+/// buffer
+template <class Sink>
+void serialize(const json& value, Sink& sink)
+{
+    detail::buffered_output<Sink> output(sink);
+    detail::serializer<detail::buffered_output<Sink>>(output).write(value);
+    output.flush();
 }
 
-json::json(class_type type) : json()
+/// Writes the value to the sink in the indented format, through a fixed
+/// size buffer
+template <class Sink>
+void serialize(const json& value, Sink& sink, uint32_t depth,
+               std::string_view tab)
 {
-    set_type(type);
+    detail::buffered_output<Sink> output(sink);
+    detail::serializer<detail::buffered_output<Sink>>(output, depth, tab)
+        .write(value);
+    output.flush();
 }
 
-json::json(std::initializer_list<json> list) : json()
+/// Decodes a binary encoded value with one of the binary readers, which
+/// report the values to a dom_builder like the text parser does
+template <template <class> class Reader>
+json decode(const uint8_t* data, std::size_t size, std::error_code& error)
 {
-    assert(list.size() % 2 == 0 && "Missing value for key value pair.");
-    set_type(class_type::object);
-    for (auto i = list.begin(); i != list.end(); i += 2)
-    {
-        operator[](i->to_string()) = *std::next(i);
-    }
+    assert(!error);
+    const json::parse_options options;
+    detail::dom_builder builder(options, nullptr, std::string_view(), error);
+    Reader<detail::dom_builder>(data, size, builder, error).read_document();
+    if (error)
+        return json(class_type::null);
+    return builder.release();
 }
 
-json::json(json&& other) : m_internal(other.m_internal), m_type(other.m_type)
+/// The value returned by the const lookups which find no value, since they
+/// must not insert one
+const json& missing_value()
 {
-    other.m_type = class_type::null;
-    other.m_internal.m_map = nullptr;
+    static const json missing;
+    return missing;
+}
 }
 
-json::json(std::nullptr_t) : m_internal(), m_type(class_type::null)
+static_assert(sizeof(json) <= 16, "json values should fit in 16 bytes");
+
+json::json()
 {
 }
 
-json::json(const json& other)
+json::json(class_type type) : json()
 {
-    clear();
-    switch (other.m_type)
+    set_type(type);
+}
+
+json::json(class_type type, detail::arena* arena) : json()
+{
+    set_type(type, arena);
+}
+
+json::json(std::initializer_list<json> list) : json()
+{
+    assert(list.size() % 2 == 0 && "Missing value for key value pair.");
+    set_type(class_type::object);
+    for (auto i = list.begin(); i != list.end(); i += 2)
     {
-    case class_type::object:
-        m_internal.m_map = new json::object_type(
-            other.m_internal.m_map->begin(), other.m_internal.m_map->end());
-        break;
-    case class_type::array:
-        m_internal.m_array = new json::array_type(
-            other.m_internal.m_array->begin(), other.m_internal.m_array->end());
-        break;
-    case class_type::string:
-        m_internal.m_string = new std::string(*other.m_internal.m_string);
-        break;
-    default:
-        m_internal = other.m_internal;
+        assert(i->is_string());
+        internal().m_map->operator[](i->string_value()) = *std::next(i);
     }
-    m_type = other.m_type;
 }
 
-json::~json()
+json::json(std::nullptr_t)
+{
+}
+
+json::json(const json& other) : m_node(other.copy_node(false))
 {
-    clear();
 }
 
-json& json::operator=(json&& other)
+json& json::operator=(json&& other) noexcept
 {
     clear();
-    m_internal = other.m_internal;
-    m_type = other.m_type;
-    other.m_internal.m_map = nullptr;
-    other.m_type = class_type::null;
+    m_node = other.m_node;
+    other.m_node = detail::node();
     return *this;
 }
 
@@ -106,95 +142,93 @@ json& json::operator=(const json& other)
         return *this;
     }
 
+    // The copy is made before clearing, so a value nested in this one is
+    // copied from as it was.
+    detail::node node = other.copy_node(false);
     clear();
-    switch (other.m_type)
-    {
-    case class_type::object:
-        m_internal.m_map = new json::object_type(
-            other.m_internal.m_map->begin(), other.m_internal.m_map->end());
-        break;
-    case class_type::array:
-        m_internal.m_array = new json::array_type(
-            other.m_internal.m_array->begin(), other.m_internal.m_array->end());
-        break;
-    case class_type::string:
-        m_internal.m_string = new std::string(*other.m_internal.m_string);
-        break;
-    default:
-        m_internal = other.m_internal;
-    }
-    m_type = other.m_type;
+    m_node = node;
     return *this;
 }
 
-json& json::operator[](const std::string& key)
+json json::share() const
 {
-    if (m_type == class_type::null)
+    json copy;
+    copy.m_node = copy_node(true);
+    return copy;
+}
+
+json& json::operator[](std::string_view key)
+{
+    if (json_type() == class_type::null)
         set_type(class_type::object);
     assert(is_object());
-    return m_internal.m_map->operator[](key);
+    return writable_object()[key];
 }
 
-const json& json::operator[](const std::string& key) const
+const json& json::operator[](std::string_view key) const
 {
+    // The object may be shared with other values, so a missing key is not
+    // inserted and a null value is returned instead
     assert(is_object());
-    return m_internal.m_map->operator[](key);
+    auto it = internal().m_map->find(key);
+    return it != internal().m_map->end() ? it->second : missing_value();
 }
 
 json& json::operator[](std::size_t index)
 {
-    if (m_type == class_type::null)
+    if (json_type() == class_type::null)
         set_type(class_type::array);
     assert(is_array());
-    if (index >= m_internal.m_array->size())
+    auto& array = writable_array();
+    if (index >= array.size())
     {
-        m_internal.m_array->resize(index + 1);
+        array.resize(index + 1);
     }
-    return m_internal.m_array->operator[](index);
+    return array[index];
 }
 
 const json& json::operator[](std::size_t index) const
 {
     assert(is_array());
-    assert(index < m_internal.m_array->size());
-    return m_internal.m_array->operator[](index);
+    assert(index < internal().m_array->size());
+    return internal().m_array->operator[](index);
 }
 
 bool json::operator==(const json& other) const
 {
-    if (m_type != other.m_type)
+    if (json_type() != other.json_type())
     {
         return false;
     }
 
-    switch (m_type)
+    switch (json_type())
     {
     case class_type::null:
         return true;
     case class_type::object:
     {
-        auto this_map = m_internal.m_map;
-        auto other_map = other.m_internal.m_map;
+        auto this_map = internal().m_map;
+        auto other_map = other.internal().m_map;
         return this_map->size() == other_map->size() &&
                std::equal(this_map->begin(), this_map->end(),
                           other_map->begin());
     }
     case class_type::array:
     {
-        auto this_array = m_internal.m_array;
-        auto other_array = other.m_internal.m_array;
+        auto this_array = internal().m_array;
+        auto other_array = other.internal().m_array;
         return this_array->size() == other_array->size() &&
                std::equal(this_array->begin(), this_array->end(),
                           other_array->begin());
     }
     case class_type::string:
-        return (*m_internal.m_string) == (*other.m_internal.m_string);
+        return string_value() == other.string_value();
     case class_type::floating:
-        return m_internal.m_float == other.m_internal.m_float;
+        return internal().m_float == other.internal().m_float;
     case class_type::integral:
-        return m_internal.m_int == other.m_internal.m_int;
+        return internal().m_int == other.internal().m_int;
     case class_type::boolean:
-        return m_internal.m_bool == other.m_internal.m_bool;
+        return internal().m_bool == other.internal().m_bool;
     }
 
     return true;
@@ -211,38 +245,114 @@ bool json::operator!=(const json& other) const
     return !(*this == other);
 }
 
-json& json::at(const std::string& key)
+json& json::at(std::string_view key)
 {
     assert(is_object());
     assert(has_key(key));
-    return m_internal.m_map->at(key);
+    return writable_object().at(key);
 }
 
-const json& json::at(const std::string& key) const
+const json& json::at(std::string_view key) const
 {
     assert(is_object());
     assert(has_key(key));
-    return m_internal.m_map->at(key);
+    return internal().m_map->at(key);
 }
 
 json& json::at(std::size_t index)
 {
     assert(is_array());
     assert(index < size());
-    return m_internal.m_array->at(index);
+    return writable_array().at(index);
 }
 
 const json& json::at(std::size_t index) const
 {
     assert(is_array());
     assert(index < size());
-    return m_internal.m_array->at(index);
+    return internal().m_array->at(index);
+}
+
+const json& json::at_pointer(std::string_view pointer,
+                             std::error_code& error) const
+{
+    assert(!error);
+    const json* value = this;
+
+    // Tokens after a missing value are still checked, so invalid pointers
+    // are reported as such
+    std::string buffer;
+    detail::for_each_pointer_token(
+        pointer, buffer, error,
+        [&value](std::string_view key, std::size_t index)
+        {
+            if (value != nullptr)
+                value = value->find_child(key, index);
+        });
+
+    if (error)
+        return missing_value();
+
+    if (value == nullptr)
+    {
+        error = bourne::error::pointer_not_found;
+        return missing_value();
+    }
+    return *value;
+}
+
+const json& json::at_pointer(std::string_view pointer) const
+{
+    std::error_code error;
+    const json& result = at_pointer(pointer, error);
+    throw_if_error(error);
+    return result;
+}
+
+const json& json::at_pointer(const compiled_pointer& pointer,
+                             std::error_code& error) const
+{
+    assert(!error);
+    const json* value = this;
+    for (const auto& token : pointer.m_tokens)
+    {
+        value = value->find_child(token.m_key, token.m_index);
+        if (value == nullptr)
+        {
+            error = bourne::error::pointer_not_found;
+            return missing_value();
+        }
+    }
+    return *value;
+}
+
+const json& json::at_pointer(const compiled_pointer& pointer) const
+{
+    std::error_code error;
+    const json& result = at_pointer(pointer, error);
+    throw_if_error(error);
+    return result;
+}
+
+const json* json::find_child(std::string_view key, std::size_t index) const
+{
+    if (is_object())
+    {
+        auto it = internal().m_map->find(key);
+        return it != internal().m_map->end() ? &it->second : nullptr;
+    }
+    if (is_array())
+    {
+        const auto& array = *internal().m_array;
+        return index < array.size() ? &array[index] : nullptr;
+    }
+    return nullptr;
 }
 
-bool json::has_key(const std::string& key) const
+bool json::has_key(std::string_view key) const
 {
     assert(is_object());
-    return m_internal.m_map->find(key) != m_internal.m_map->end();
+    return internal().m_map->find(key) != internal().m_map->end();
 }
 
 std::vector<std::string> json::keys() const
@@ -250,10 +360,10 @@ std::vector<std::string> json::keys() const
     assert(is_object());
     std::vector<std::string> keys;
 
-    std::transform(std::begin(*m_internal.m_map), std::end(*m_internal.m_map),
+    std::transform(std::begin(*internal().m_map), std::end(*internal().m_map),
                    std::back_inserter(keys),
-                   [](const std::pair<std::string, json>& pair)
-                   { return pair.first; });
+                   [](const object_type::value_type& pair)
+                   { return std::string(pair.first.view()); });
     return keys;
 }
 
@@ -261,240 +371,265 @@ std::size_t json::size() const
 {
     assert(is_array() || is_object());
     if (is_object())
-        return m_internal.m_map->size();
+        return internal().m_map->size();
     if (is_array())
-        return m_internal.m_array->size();
+        return internal().m_array->size();
 
     return 0;
 }
 
-class_type json::json_type() const
+std::size_t json::capacity() const
 {
-    return m_type;
+    assert(is_array() || is_object());
+    if (is_object())
+        return internal().m_map->capacity();
+    if (is_array())
+        return internal().m_array->capacity();
+
+    return 0;
+}
+
+void json::reserve(std::size_t size)
+{
+    assert(is_array() || is_object());
+    if (is_object())
+        writable_object().reserve(size);
+    if (is_array())
+        writable_array().reserve(size);
+}
+
+void json::shrink_to_fit()
+{
+    assert(is_array() || is_object());
+    if (is_object())
+        writable_object().shrink_to_fit();
+    if (is_array())
+        writable_array().shrink_to_fit();
 }
 
 bool json::is_null() const
 {
-    return m_type == class_type::null;
+    return json_type() == class_type::null;
 }
 
 bool json::is_bool() const
 {
-    return m_type == class_type::boolean;
+    return json_type() == class_type::boolean;
 }
 
 bool json::is_int() const
 {
-    return m_type == class_type::integral;
+    return json_type() == class_type::integral;
 }
 
 bool json::is_float() const
 {
-    return m_type == class_type::floating || m_type == class_type::integral;
+    return json_type() == class_type::floating ||
+           json_type() == class_type::integral;
 }
 
 bool json::is_string() const
 {
-    return m_type == class_type::string;
+    return json_type() == class_type::string;
 }
 
 bool json::is_object() const
 {
-    return m_type == class_type::object;
+    return json_type() == class_type::object;
 }
 
 bool json::is_array() const
 {
-    return m_type == class_type::array;
+    return json_type() == class_type::array;
 }
 
 bool json::to_bool() const
 {
     assert(is_bool());
-    return m_internal.m_bool;
+    return internal().m_bool;
 }
 
 int64_t json::to_int() const
 {
     assert(is_int());
-    return m_internal.m_int;
+    return internal().m_int;
 }
 
 double json::to_float() const
 {
     assert(is_float());
-    if (m_type == class_type::floating)
+    if (json_type() == class_type::floating)
     {
-        return m_internal.m_float;
+        return internal().m_float;
     }
     else
     {
-        assert(m_type == class_type::integral);
-        return (double)m_internal.m_int;
+        assert(json_type() == class_type::integral);
+        return (double)internal().m_int;
     }
 }
 
 std::string json::to_string() const
 {
     assert(is_string());
-    const std::string& str = *m_internal.m_string;
     std::string output;
-    auto size = str.length();
-    for (std::size_t i = 0; i < size; ++i)
-    {
-        switch (str[i])
-        {
-        case '\"':
-            output += "\\\"";
-            break;
-        case '\\':
-        {
-            // Check if the next character is a unicode escape sequence
-            if (i + 1 < size && str[i + 1] == 'u')
-            {
-                output += "\\u";
-                i += 1;
-                break;
-            }
-            output += "\\\\";
-            break;
-        }
-        case '\b':
-            output += "\\b";
-            break;
-        case '\f':
-            output += "\\f";
-            break;
-        case '\n':
-            output += "\\n";
-            break;
-        case '\r':
-            output += "\\r";
-            break;
-        case '\t':
-            output += "\\t";
-            break;
-        default:
-            output += str[i];
-            break;
-        }
-    }
-
+    detail::string_sink sink(output);
+    detail::write_escaped(string_value(), sink);
     return output;
 }
 
+std::string_view json::to_string_view() const
+{
+    return string_value();
+}
+
 detail::json_wrapper<json::object_type> json::object_range()
 {
     assert(is_object());
-    return detail::json_wrapper<json::object_type>(m_internal.m_map);
+    return detail::json_wrapper<json::object_type>(&writable_object());
 }
 
 detail::json_const_wrapper<json::object_type> json::object_range() const
 {
     assert(is_object());
-    return detail::json_const_wrapper<json::object_type>(m_internal.m_map);
+    return detail::json_const_wrapper<json::object_type>(internal().m_map);
 }
 
 detail::json_wrapper<json::array_type> json::array_range()
 {
     assert(is_array());
-    return detail::json_wrapper<json::array_type>(m_internal.m_array);
+    return detail::json_wrapper<json::array_type>(&writable_array());
 }
 
 detail::json_const_wrapper<json::array_type> json::array_range() const
 {
     assert(is_array());
-    return detail::json_const_wrapper<json::array_type>(m_internal.m_array);
+    return detail::json_const_wrapper<json::array_type>(internal().m_array);
 }
 
 std::string json::dump(uint32_t depth, std::string tab) const
 {
-    std::string pad = "";
+    std::string output;
+    dump_to(output, depth, tab);
+    return output;
+}
 
-    for (uint32_t i = 0; i < depth; ++i, pad += tab)
-        ;
+std::string json::dump_min() const
+{
+    std::string output;
+    dump_min_to(output);
+    return output;
+}
 
-    switch (m_type)
-    {
-    case class_type::null:
-        return "null";
-    case class_type::object:
-    {
-        std::stringstream s;
-        s << "{\n";
-        const char* sep = "";
-        for (auto& p : *m_internal.m_map)
-        {
-            s << sep << pad << "\"" << p.first << "\" : ";
-            s << p.second.dump(depth + 1, tab);
-            sep = ",\n";
-        }
-        s << "\n" << pad.erase(0, tab.size()) << "}";
-        return s.str();
-    }
-    case class_type::array:
-    {
-        std::stringstream s;
-        s << "[";
-        const char* sep = "";
-        for (auto& p : *m_internal.m_array)
-        {
-            s << sep << p.dump(depth + 1, tab);
-            sep = ", ";
-        }
-        s << "]";
-        return s.str();
-    }
-    case class_type::string:
-        return "\"" + to_string() + "\"";
-    case class_type::floating:
-        return std::to_string(m_internal.m_float);
-    case class_type::integral:
-        return std::to_string(m_internal.m_int);
-    case class_type::boolean:
-        return m_internal.m_bool ? "true" : "false";
-    default:
-        return "";
-    }
+void json::dump_to(std::string& output, uint32_t depth,
+                   std::string_view tab) const
+{
+    detail::string_sink sink(output);
+    serialize(*this, sink, depth, tab);
 }
-std::string json::dump_min() const
+
+void json::dump_min_to(std::string& output) const
 {
-    switch (m_type)
-    {
-    case class_type::object:
-    {
-        std::stringstream s;
-        s << "{";
-        const char* sep = "";
-        for (auto& p : *m_internal.m_map)
-        {
-            s << sep << "\"" << p.first << "\":" << p.second.dump_min();
-            sep = ",";
-        }
-        s << "}";
-        return s.str();
-    }
-    case class_type::array:
-    {
-        std::stringstream s;
-        s << "[";
-        const char* sep = "";
-        for (auto& p : *m_internal.m_array)
-        {
-            s << sep << p.dump_min();
-            sep = ",";
-        }
-        s << "]";
-        return s.str();
-    }
-    case class_type::null:
-    case class_type::string:
-    case class_type::floating:
-    case class_type::integral:
-    case class_type::boolean:
-    default:
-        return dump(0, "");
-    }
+    detail::string_sink sink(output);
+    serialize(*this, sink);
+}
+
+void json::dump_to(std::ostream& output, uint32_t depth,
+                   std::string_view tab) const
+{
+    detail::ostream_sink sink(output);
+    serialize(*this, sink, depth, tab);
+}
+
+void json::dump_min_to(std::ostream& output) const
+{
+    detail::ostream_sink sink(output);
+    serialize(*this, sink);
+}
+
+void json::dump_to(const write_function& write, uint32_t depth,
+                   std::string_view tab) const
+{
+    detail::function_sink sink(write);
+    serialize(*this, sink, depth, tab);
+}
+
+void json::dump_min_to(const write_function& write) const
+{
+    detail::function_sink sink(write);
+    serialize(*this, sink);
+}
+
+void json::dump_to_fd(int fd, std::error_code& error) const
+{
+    assert(!error);
+    detail::fd_sink sink(fd, error);
+    serialize(*this, sink, 1, "  ");
+}
+
+void json::dump_to_fd(int fd) const
+{
+    std::error_code error;
+    dump_to_fd(fd, error);
+    throw_if_error(error);
+}
+
+void json::dump_min_to_fd(int fd, std::error_code& error) const
+{
+    assert(!error);
+    detail::fd_sink sink(fd, error);
+    serialize(*this, sink);
+}
+
+void json::dump_min_to_fd(int fd) const
+{
+    std::error_code error;
+    dump_min_to_fd(fd, error);
+    throw_if_error(error);
+}
+
+void json::to_cbor(std::vector<uint8_t>& output) const
+{
+    detail::write_cbor(*this, output);
+}
+
+std::vector<uint8_t> json::to_cbor() const
+{
+    std::vector<uint8_t> output;
+    to_cbor(output);
+    return output;
+}
+
+void json::to_msgpack(std::vector<uint8_t>& output) const
+{
+    detail::write_msgpack(*this, output);
+}
+
+std::vector<uint8_t> json::to_msgpack() const
+{
+    std::vector<uint8_t> output;
+    to_msgpack(output);
+    return output;
+}
+
+void json::to_tape(std::vector<uint8_t>& output, std::error_code& error) const
+{
+    assert(!error);
+    detail::write_tape(*this, output, error);
+}
+
+void json::to_tape(std::vector<uint8_t>& output) const
+{
+    std::error_code error;
+    to_tape(output, error);
+    throw_if_error(error);
+}
+
+std::vector<uint8_t> json::to_tape() const
+{
+    std::vector<uint8_t> output;
+    to_tape(output);
+    return output;
 }
 
 bool json::contains(const json& other) const
@@ -534,29 +669,185 @@ bool json::contains(const json& other) const
     return false;
 }
 
-json json::parse(const std::string& input, std::error_code& error)
+json json::parse(std::string_view input, std::error_code& error)
 {
     assert(!error);
     return detail::parser::parse(input, json::parse_options{}, error);
 }
 
-json json::parse(const std::string& input, const json::parse_options& options,
+json json::parse(std::string_view input, const json::parse_options& options,
                  std::error_code& error)
 {
     assert(!error);
     return detail::parser::parse(input, options, error);
 }
 
-json json::parse(const std::string& input)
+json json::parse(std::string_view input)
 {
     return detail::parser::parse(input, json::parse_options{});
 }
 
-json json::parse(const std::string& input, const json::parse_options& options)
+json json::parse(std::string_view input, const json::parse_options& options)
 {
     return detail::parser::parse(input, options);
 }
 
+void json::parse(std::string_view input, handler& handler,
+                 std::error_code& error)
+{
+    assert(!error);
+    detail::parser::parse(input, json::parse_options{}, handler, error);
+}
+
+void json::parse(std::string_view input, const json::parse_options& options,
+                 handler& handler, std::error_code& error)
+{
+    assert(!error);
+    detail::parser::parse(input, options, handler, error);
+}
+
+void json::parse(std::string_view input, handler& handler)
+{
+    parse(input, json::parse_options{}, handler);
+}
+
+void json::parse(std::string_view input, const json::parse_options& options,
+                 handler& handler)
+{
+    std::error_code error;
+    detail::parser::parse(input, options, handler, error);
+    throw_if_error(error);
+}
+
+json json::parse(const char* data, std::size_t size, std::error_code& error)
+{
+    return parse(std::string_view(data, size), error);
+}
+
+json json::parse(const char* data, std::size_t size,
+                 const json::parse_options& options, std::error_code& error)
+{
+    return parse(std::string_view(data, size), options, error);
+}
+
+json json::parse(const char* data, std::size_t size)
+{
+    return parse(std::string_view(data, size));
+}
+
+json json::parse(const char* data, std::size_t size,
+                 const json::parse_options& options)
+{
+    return parse(std::string_view(data, size), options);
+}
+
+void json::parse(const char* data, std::size_t size, handler& handler,
+                 std::error_code& error)
+{
+    parse(std::string_view(data, size), handler, error);
+}
+
+void json::parse(const char* data, std::size_t size,
+                 const json::parse_options& options, handler& handler,
+                 std::error_code& error)
+{
+    parse(std::string_view(data, size), options, handler, error);
+}
+
+void json::parse(const char* data, std::size_t size, handler& handler)
+{
+    parse(std::string_view(data, size), handler);
+}
+
+void json::parse(const char* data, std::size_t size,
+                 const json::parse_options& options, handler& handler)
+{
+    parse(std::string_view(data, size), options, handler);
+}
+
+json json::parse_file(const std::string& path, std::error_code& error)
+{
+    return parse_file(path, json::parse_options{}, error);
+}
+
+json json::parse_file(const std::string& path,
+                      const json::parse_options& options,
+                      std::error_code& error)
+{
+    assert(!error);
+    detail::mapped_file file(path, error);
+    if (error)
+        return json(class_type::null);
+
+    // The strings cannot refer to the file once it is unmapped
+    json::parse_options file_options = options;
+    file_options.borrow_strings = false;
+    return detail::parser::parse(file.data(), file_options, error);
+}
+
+json json::parse_file(const std::string& path)
+{
+    return parse_file(path, json::parse_options{});
+}
+
+json json::parse_file(const std::string& path,
+                      const json::parse_options& options)
+{
+    std::error_code error;
+    auto result = parse_file(path, options, error);
+    throw_if_error(error);
+    return result;
+}
+
+json json::from_cbor(const uint8_t* data, std::size_t size,
+                     std::error_code& error)
+{
+    return decode<detail::cbor_reader>(data, size, error);
+}
+
+json json::from_cbor(const uint8_t* data, std::size_t size)
+{
+    std::error_code error;
+    auto result = from_cbor(data, size, error);
+    throw_if_error(error);
+    return result;
+}
+
+json json::from_cbor(const std::vector<uint8_t>& data, std::error_code& error)
+{
+    return from_cbor(data.data(), data.size(), error);
+}
+
+json json::from_cbor(const std::vector<uint8_t>& data)
+{
+    return from_cbor(data.data(), data.size());
+}
+
+json json::from_msgpack(const uint8_t* data, std::size_t size,
+                        std::error_code& error)
+{
+    return decode<detail::msgpack_reader>(data, size, error);
+}
+
+json json::from_msgpack(const uint8_t* data, std::size_t size)
+{
+    std::error_code error;
+    auto result = from_msgpack(data, size, error);
+    throw_if_error(error);
+    return result;
+}
+
+json json::from_msgpack(const std::vector<uint8_t>& data,
+                        std::error_code& error)
+{
+    return from_msgpack(data.data(), data.size(), error);
+}
+
+json json::from_msgpack(const std::vector<uint8_t>& data)
+{
+    return from_msgpack(data.data(), data.size());
+}
+
 json json::array()
 {
     return json(class_type::array);
@@ -579,56 +870,181 @@ json json::object(std::initializer_list<json> list)
 
 void json::clear()
 {
-    switch (m_type)
+    if (owns_storage())
     {
-    case class_type::array:
-        delete m_internal.m_array;
-        break;
-    case class_type::object:
-        delete m_internal.m_map;
-        break;
-    case class_type::string:
-        delete m_internal.m_string;
-        break;
-    default:;
+        switch (json_type())
+        {
+        case class_type::array:
+            detail::destroy(internal().m_array);
+            break;
+        case class_type::object:
+            detail::destroy(internal().m_map);
+            break;
+        case class_type::string:
+            detail::destroy(internal().m_string);
+            break;
+        default:;
+        }
     }
-    m_type = class_type::null;
+    m_node = detail::node();
 }
 
-void json::set_type(class_type type)
+void json::set_type(class_type type, detail::arena* arena)
 {
     clear();
+    if (type == class_type::string)
+    {
+        set_string(std::string_view(), arena);
+        return;
+    }
+
+    set_long(type);
     switch (type)
     {
     case class_type::null:
-        m_internal.m_map = nullptr;
+        internal().m_map = nullptr;
         break;
     case class_type::object:
-        m_internal.m_map = new json::object_type();
+        internal().m_map = detail::create<json::object_type>(arena);
         break;
     case class_type::array:
-        m_internal.m_array = new json::array_type();
+        internal().m_array = detail::create<json::array_type>(arena);
         break;
     case class_type::string:
-        m_internal.m_string = new std::string();
+        assert(0 && "Strings are set by set_string()");
         break;
     case class_type::floating:
-        m_internal.m_float = 0.0;
+        internal().m_float = 0.0;
         break;
     case class_type::integral:
-        m_internal.m_int = 0;
+        internal().m_int = 0;
         break;
     case class_type::boolean:
-        m_internal.m_bool = false;
+        internal().m_bool = false;
+        break;
+    }
+}
+
+detail::node json::copy_node(bool share) const
+{
+    // Copies of borrowed strings own their characters, so they do not
+    // depend on the lifetime of the input
+    if (is_borrowed_string() && !share)
+    {
+        detail::node node;
+        node.m_long.m_type = class_type::string;
+        node.m_long.m_internal.m_string = detail::create<string_type>(
+            nullptr, string_value().data(), string_value().size());
+        return node;
+    }
+
+    if (!owns_storage())
+        return m_node;
+
+    detail::node node;
+    node.m_long.m_type = json_type();
+    switch (json_type())
+    {
+    case class_type::object:
+        node.m_long.m_internal.m_map =
+            detail::copy_or_share(internal().m_map, share);
+        break;
+    case class_type::array:
+        node.m_long.m_internal.m_array =
+            detail::copy_or_share(internal().m_array, share);
+        break;
+    case class_type::string:
+        // Strings are replaced rather than modified, so they are shared
+        node.m_long.m_internal.m_string =
+            detail::copy_or_share(internal().m_string, true);
         break;
+    default:
+        assert(0 && "Only objects, arrays and strings own storage");
+    }
+    return node;
+}
+
+json::object_type& json::writable_object()
+{
+    object_type*& object = internal().m_map;
+    if (detail::is_shared(object))
+    {
+        // The members are already sorted, so they are appended
+        auto copy = detail::create<object_type>(nullptr);
+        copy->reserve(object->size());
+        for (const auto& member : *object)
+            copy->append(detail::key(member.first)) = member.second.share();
+        detail::destroy(object);
+        object = copy;
+    }
+    return *object;
+}
+
+json::array_type& json::writable_array()
+{
+    array_type*& array = internal().m_array;
+    if (detail::is_shared(array))
+    {
+        auto copy = detail::create<array_type>(nullptr);
+        copy->reserve(array->size());
+        for (const auto& element : *array)
+            copy->push_back(element.share());
+        detail::destroy(array);
+        array = copy;
+    }
+    return *array;
+}
+
+std::string_view json::string_value() const
+{
+    assert(is_string());
+    if (is_short_string())
+    {
+        return std::string_view(m_node.m_short.m_data,
+                                m_node.m_short.m_short_size);
+    }
+    if (is_borrowed_string())
+    {
+        return std::string_view(m_node.m_borrowed.m_data,
+                                m_node.m_borrowed.m_size);
+    }
+    const string_type& string = *internal().m_string;
+    return std::string_view(string.data(), string.size());
+}
+
+void json::set_string(std::string_view string, detail::arena* arena)
+{
+    clear();
+    if (string.size() <= detail::short_string_capacity)
+    {
+        m_node.m_short = {class_type::string, uint8_t(string.size()), {}};
+        std::memcpy(m_node.m_short.m_data, string.data(), string.size());
+        return;
     }
 
-    m_type = type;
+    set_long(class_type::string);
+    internal().m_string =
+        detail::create<string_type>(arena, string.data(), string.size());
+}
+
+void json::set_borrowed_string(std::string_view string)
+{
+    // Sizes which do not fit the borrowed layout are copied instead
+    if (string.size() <= detail::short_string_capacity ||
+        string.size() > UINT32_MAX)
+    {
+        set_string(string);
+        return;
+    }
+
+    clear();
+    m_node.m_borrowed = {class_type::string, detail::borrowed,
+                         uint32_t(string.size()), string.data()};
 }
 
 std::ostream& operator<<(std::ostream& os, const json& json)
 {
-    os << json.dump();
+    json.dump_to(os);
     return os;
 }
 }
@@ -5,13 +5,17 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <ostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "class_type.hpp"
@@ -24,9 +28,26 @@ namespace bourne
 {
 inline namespace STEINWURF_BOURNE_VERSION
 {
+class compiled_pointer;
+class handler;
+
+namespace detail
+{
+class dom_builder;
+
+template <class Output>
+class serializer;
+}
+
 /// A json object
 class json
 {
+private:
+    friend class detail::dom_builder;
+
+    template <class Output>
+    friend class detail::serializer;
+
 private:
     template <class T, class R = void>
     using check_is_bool = std::enable_if<std::is_same<T, bool>::value, R>;
@@ -48,6 +69,8 @@ private:
 
     using array_type = detail::backing_data::array_type;
 
+    using string_type = detail::backing_data::string_type;
+
 public:
     struct parse_options
     {
@@ -56,8 +79,36 @@ public:
         /// Currently this enables:
         /// - bourne::error::parse_object_duplicate_key
         bool strict = false;
+
+        /// Parse in two stages. The first stage uses SIMD instructions, when
+        /// the CPU supports them, to index the structural characters of the
+        /// input. The second stage builds the json value using the index to
+        /// skip white space. The result and errors are the same as when
+        /// parsing in a single stage.
+        bool two_stage = false;
+
+        /// Share the storage of equal object keys between the objects of
+        /// the parsed value. Keys longer than 15 bytes are otherwise stored
+        /// once per object, which for arrays of objects with the same keys
+        /// uses more memory.
+        bool intern_keys = false;
+
+        /// Store strings and object keys without escape sequences as views
+        /// of the input instead of copying them. Only strings with escape
+        /// sequences are decoded into storage of their own.
+        ///
+        /// The input must outlive the parsed value, unless it is parsed as
+        /// a bourne::document which keeps a copy of the input. Copies of
+        /// the value own their strings. Has no effect on
+        /// bourne::stream_parser, which does not keep its input.
+        bool borrow_strings = false;
     };
 
+    /// Function receiving the chunks of a json string written by dump_to()
+    /// and dump_min_to()
+    using write_function =
+        std::function<void(const char* data, std::size_t size)>;
+
     /// Default constructor, creates a null value.
     json();
 
@@ -71,57 +122,88 @@ public:
 
     /// Move constructor.
     /// Ensures the backing_data is owned my the correct object.
-    json(json&& other);
+    /// Defined inline, since arrays and objects move their elements when
+    /// they grow.
+    json(json&& other) noexcept : m_node(other.m_node)
+    {
+        other.m_node = detail::node();
+    }
 
-    /// Copy constructor.
+    /// Copy constructor. The objects and arrays of other are copied, its
+    /// long strings, which are never modified in place, are shared.
     json(const json& other);
 
     /// Constructor for creating a boolean value.
     template <typename T>
-    json(T b, typename check_is_bool<T>::type* = 0) :
-        m_internal(b), m_type(class_type::boolean)
+    json(T b, typename check_is_bool<T>::type* = 0)
     {
+        set_long(class_type::boolean);
+        internal().m_bool = b;
     }
 
     /// Constructor for creating an integral value.
     template <typename T>
-    json(T i, typename check_is_integral<T>::type* = 0) :
-        m_internal((int64_t)i), m_type(class_type::integral)
+    json(T i, typename check_is_integral<T>::type* = 0)
     {
+        set_long(class_type::integral);
+        internal().m_int = (int64_t)i;
     }
 
     /// Constructor for creating a floating point value.
     template <typename T>
-    json(T f, typename check_is_floating_point<T>::type* = 0) :
-        m_internal((double)f), m_type(class_type::floating)
+    json(T f, typename check_is_floating_point<T>::type* = 0)
     {
+        set_long(class_type::floating);
+        internal().m_float = (double)f;
     }
 
     /// Constructor for creating a string value.
     template <typename T>
-    json(T s, typename check_is_string<T>::type* = 0) :
-        m_internal(std::string(s)), m_type(class_type::string)
+    json(T s, typename check_is_string<T>::type* = 0)
     {
+        set_string(to_string_argument(s));
     }
 
     /// Constructor for creating a null value.
     json(std::nullptr_t);
 
     /// Destructor
-    ~json();
+    ~json()
+    {
+        // Moved from values, primitive values and short strings own no
+        // storage
+        if (owns_storage())
+            clear();
+    }
 
     /// Assignment operator for json
-    json& operator=(json&& other);
+    json& operator=(json&& other) noexcept;
 
     /// Assignment operator for json
     json& operator=(const json& other);
 
+    /// Returns a copy of this value which shares its objects, arrays and
+    /// long strings, so it is made in constant time. The values sharing
+    /// storage copy an object or array before modifying it, and only that
+    /// object or array, so the others are not affected. Values sharing
+    /// storage can be read and shared from several threads, as long as each
+    /// value is modified by one thread at a time.
+    ///
+    /// Sharing a value invalidates the references into it, as modifying a
+    /// shared value copies what it modifies: a reference taken before would
+    /// modify the storage of the other values, or refer to storage released
+    /// with them. Strings borrowed from the input are shared too, also when
+    /// moved into objects and arrays built by the user, so the copy depends
+    /// on the input like this value does. Use the copy constructor for a
+    /// copy which owns its strings.
+    json share() const;
+
     /// Assignment operator for boolean
     template <typename T>
     typename check_is_bool<T, json&>::type operator=(T b)
     {
         set_type(class_type::boolean);
-        m_internal.m_bool = b;
+        internal().m_bool = b;
         return *this;
     }
 
@@ -130,7 +212,7 @@ public:
     typename check_is_integral<T, json&>::type operator=(T i)
     {
         set_type(class_type::integral);
-        m_internal.m_int = i;
+        internal().m_int = i;
         return *this;
     }
 
@@ -139,7 +221,7 @@ public:
     typename check_is_floating_point<T, json&>::type operator=(T f)
     {
         set_type(class_type::floating);
-        m_internal.m_float = f;
+        internal().m_float = f;
         return *this;
     }
 
@@ -147,10 +229,7 @@ public:
     template <typename T>
     typename check_is_string<T, json&>::type operator=(T s)
     {
-        set_type(class_type::string);
-
-        // use assignment operator to copy over the string
-        *m_internal.m_string = std::string(s);
+        set_string(to_string_argument(s));
         return *this;
     }
 
@@ -158,13 +237,22 @@ public:
     json& operator=(std::nullptr_t);
 
     /// Access operator for keys this assumes the json value is of type object
-    json& operator[](const std::string& key);
+    ///
+    /// Inserting a missing key does not move the other members, so
+    /// references to them stay valid, as in obj["a"] = obj["b"].
+    json& operator[](std::string_view key);
 
     /// Access operator for keys this assumes the json value is of type object
-    const json& operator[](const std::string& key) const;
+    /// @return The member with the key, or a null value if there is none
+    const json& operator[](std::string_view key) const;
 
     /// Access operator for index this assumes the json value is of type array
     /// given index
+    ///
+    /// An index past the end grows the array, which invalidates references
+    /// to its elements unless it has the capacity, so an element assigned
+    /// to a new element must be copied first, as in
+    /// array[7] = bourne::json(array[0]), or reserved with reserve().
     json& operator[](std::size_t index);
 
     /// Access operator for keys this assumes the json value is of type array
@@ -173,11 +261,11 @@ public:
 
     /// Returns a reference to the json value of the element identified with the
     /// given key.
-    json& at(const std::string& key);
+    json& at(std::string_view key);
 
     /// Returns a reference to the json value of the element identified with the
     /// given key.
-    const json& at(const std::string& key) const;
+    const json& at(std::string_view key) const;
 
     /// Returns a reference to the json value of the element identified with the
     /// given key.
@@ -187,28 +275,60 @@ public:
     /// given key.
     const json& at(std::size_t index) const;
 
+    /// Returns the value referred to by an RFC 6901 JSON pointer, such as
+    /// "/servers/0/port". Fails with bourne::error::pointer_invalid_syntax
+    /// if the pointer is invalid, and with bourne::error::pointer_not_found
+    /// if it refers to no value, in which case a null value is returned.
+    /// Missing members are never inserted.
+    const json& at_pointer(std::string_view pointer,
+                           std::error_code& error) const;
+
+    /// Returns the value referred to by an RFC 6901 JSON pointer.
+    const json& at_pointer(std::string_view pointer) const;
+
+    /// Returns the value referred to by a compiled JSON pointer. Fails with
+    /// bourne::error::pointer_not_found if it refers to no value, in which
+    /// case a null value is returned. The lookup does not allocate.
+    const json& at_pointer(const compiled_pointer& pointer,
+                           std::error_code& error) const;
+
+    /// Returns the value referred to by a compiled JSON pointer.
+    const json& at_pointer(const compiled_pointer& pointer) const;
+
     /// Append a json value to this json array. If this object is not a json
-    /// array, an assert will be triggered.
+    /// array, an assert will be triggered. A json value passed as an rvalue
+    /// is moved into the array.
     template <typename T>
-    void append(T arg)
+    void append(T&& arg)
     {
         assert(is_array());
-        m_internal.m_array->emplace_back(arg);
+        writable_array().emplace_back(std::forward<T>(arg));
     }
 
     /// Append multiple json values to this json array. If this object is not a
     /// json array, an assert will be triggered.
     template <typename T, typename... U>
-    void append(T arg, U... args)
+    void append(T&& arg, U&&... args)
     {
         assert(is_array());
-        append(arg);
-        append(args...);
+        append(std::forward<T>(arg));
+        append(std::forward<U>(args)...);
+    }
+
+    /// Constructs a json value from the arguments at the end of this json
+    /// array. If this object is not a json array, an assert will be
+    /// triggered.
+    /// @return The value constructed
+    template <typename... T>
+    json& emplace_back(T&&... args)
+    {
+        assert(is_array());
+        return writable_array().emplace_back(std::forward<T>(args)...);
     }
 
     /// Returns true if the key is available. This functions assumes this object
     /// is a json object value.
-    bool has_key(const std::string& key) const;
+    bool has_key(std::string_view key) const;
 
     /// Returns the available set of keys. This functions assumes this object
     /// is a json object value.
@@ -218,8 +338,25 @@ public:
     /// an object or array, an assert will be triggered.
     std::size_t size() const;
 
+    /// Returns the number of elements this object or array can hold before it
+    /// has to grow its storage. If this is not an object or array, an assert
+    /// will be triggered.
+    std::size_t capacity() const;
+
+    /// Reserves storage for the given number of elements in this object or
+    /// array, so they can be added without growing the storage. If this is
+    /// not an object or array, an assert will be triggered.
+    void reserve(std::size_t size);
+
+    /// Releases the storage this object or array holds beyond its size. If
+    /// this is not an object or array, an assert will be triggered.
+    void shrink_to_fit();
+
     /// Returns the type of this object.
-    class_type json_type() const;
+    class_type json_type() const
+    {
+        return m_node.m_long.m_type;
+    }
 
     /// Returns true if this object matches the given type
     template <class T>
@@ -309,8 +446,16 @@ public:
     /// string value an assert is triggered.
     std::string to_string() const;
 
-    /// Returns an iterable object range. If this is not an object value an
-    /// assert is triggered.
+    /// Returns a view of the characters of this string value, without the
+    /// escaping done by to_string() and without allocating. The view is
+    /// valid until the value is changed or destroyed, or for strings
+    /// borrowed from the input, while the input is. If this is not a string
+    /// value an assert is triggered.
+    std::string_view to_string_view() const;
+
+    /// Returns an iterable object range over the members in key order. The
+    /// keys are const, and convert to std::string and std::string_view. If
+    /// this is not an object value an assert is triggered.
     detail::json_wrapper<object_type> object_range();
 
     /// Returns an const iterable object range. If this is not an object value
@@ -331,6 +476,73 @@ public:
     /// Dumps this object as a minified json string.
     std::string dump_min() const;
 
+    /// Appends this object as a json string to the output, formatted as by
+    /// dump(). The output may be reused between calls to avoid allocations.
+    void dump_to(std::string& output, uint32_t depth = 1,
+                 std::string_view tab = "  ") const;
+
+    /// Appends this object as a minified json string to the output.
+    void dump_min_to(std::string& output) const;
+
+    /// Writes this object as a json string to the stream, formatted as by
+    /// dump(). The string is written in chunks from a fixed size buffer, so
+    /// it is never held in memory as a whole.
+    void dump_to(std::ostream& output, uint32_t depth = 1,
+                 std::string_view tab = "  ") const;
+
+    /// Writes this object as a minified json string to the stream.
+    void dump_min_to(std::ostream& output) const;
+
+    /// Passes this object as a json string to the function in chunks,
+    /// formatted as by dump().
+    void dump_to(const write_function& write, uint32_t depth = 1,
+                 std::string_view tab = "  ") const;
+
+    /// Passes this object as a minified json string to the function in
+    /// chunks.
+    void dump_min_to(const write_function& write) const;
+
+    /// Writes this object as a json string to the file descriptor, formatted
+    /// as by dump(). Partial and interrupted writes are retried.
+    void dump_to_fd(int fd, std::error_code& error) const;
+
+    /// Writes this object as a json string to the file descriptor.
+    void dump_to_fd(int fd) const;
+
+    /// Writes this object as a minified json string to the file descriptor.
+    void dump_min_to_fd(int fd, std::error_code& error) const;
+
+    /// Writes this object as a minified json string to the file descriptor.
+    void dump_min_to_fd(int fd) const;
+
+    /// Appends this object encoded as CBOR (RFC 8949) to the output. The
+    /// output may be reused between calls to avoid allocations.
+    void to_cbor(std::vector<uint8_t>& output) const;
+
+    /// Returns this object encoded as CBOR.
+    std::vector<uint8_t> to_cbor() const;
+
+    /// Appends this object encoded as MessagePack to the output. The output
+    /// may be reused between calls to avoid allocations.
+    void to_msgpack(std::vector<uint8_t>& output) const;
+
+    /// Returns this object encoded as MessagePack.
+    std::vector<uint8_t> to_msgpack() const;
+
+    /// Appends this object encoded as a binary tape to the output, which
+    /// tape_document reads without decoding it. The output may be reused
+    /// between calls to avoid allocations. Sets
+    /// bourne::error::encode_too_large and leaves the output unchanged if a
+    /// string, array or object has more than UINT32_MAX bytes, elements or
+    /// members.
+    void to_tape(std::vector<uint8_t>& output, std::error_code& error) const;
+
+    /// Appends this object encoded as a binary tape to the output.
+    void to_tape(std::vector<uint8_t>& output) const;
+
+    /// Returns this object encoded as a binary tape.
+    std::vector<uint8_t> to_tape() const;
+
     /// Friend function for the insertion operator. This will insert the json
     /// string of this object to the ostream.
     friend std::ostream& operator<<(std::ostream&, const json&);
@@ -349,27 +561,134 @@ public:
     /// false.
     bool contains(const json& other) const;
 
-    /// Parse a string as a json object.
-    static json parse(const std::string& input, std::error_code& error);
+    /// Parse a string as a json object. The input is parsed where it is, so
+    /// it does not need to be copied into a std::string first.
+    static json parse(std::string_view input, std::error_code& error);
 
     /// Parse a string as a json object with options.
-    static json parse(const std::string& input, const parse_options& options,
+    static json parse(std::string_view input, const parse_options& options,
                       std::error_code& error);
 
     /// Parse a string as a json object.
-    static json parse(const std::string& input);
+    static json parse(std::string_view input);
 
     /// Parse a string as a json object with options.
-    static json parse(const std::string& input, const parse_options& options);
+    static json parse(std::string_view input, const parse_options& options);
+
+    /// Parse a string reporting its values to the handler instead of
+    /// building a json value.
+    static void parse(std::string_view input, handler& handler,
+                      std::error_code& error);
+
+    /// Parse a string reporting its values to the handler instead of
+    /// building a json value, with options. Only the structure of the input
+    /// is checked, so the strict option has no effect.
+    static void parse(std::string_view input, const parse_options& options,
+                      handler& handler, std::error_code& error);
+
+    /// Parse a string reporting its values to the handler instead of
+    /// building a json value.
+    static void parse(std::string_view input, handler& handler);
+
+    /// Parse a string reporting its values to the handler instead of
+    /// building a json value, with options. Only the structure of the input
+    /// is checked, so the strict option has no effect.
+    static void parse(std::string_view input, const parse_options& options,
+                      handler& handler);
+
+    /// Parse the size bytes at data as a json object.
+    static json parse(const char* data, std::size_t size,
+                      std::error_code& error);
+
+    /// Parse the size bytes at data as a json object with options.
+    static json parse(const char* data, std::size_t size,
+                      const parse_options& options, std::error_code& error);
+
+    /// Parse the size bytes at data as a json object.
+    static json parse(const char* data, std::size_t size);
+
+    /// Parse the size bytes at data as a json object with options.
+    static json parse(const char* data, std::size_t size,
+                      const parse_options& options);
+
+    /// Parse the size bytes at data reporting the values to the handler.
+    static void parse(const char* data, std::size_t size, handler& handler,
+                      std::error_code& error);
+
+    /// Parse the size bytes at data reporting the values to the handler,
+    /// with options.
+    static void parse(const char* data, std::size_t size,
+                      const parse_options& options, handler& handler,
+                      std::error_code& error);
+
+    /// Parse the size bytes at data reporting the values to the handler.
+    static void parse(const char* data, std::size_t size, handler& handler);
+
+    /// Parse the size bytes at data reporting the values to the handler,
+    /// with options.
+    static void parse(const char* data, std::size_t size,
+                      const parse_options& options, handler& handler);
+
+    /// Parse the file at the path as a json object. The file is mapped into
+    /// memory and parsed where it is, without reading it into a buffer
+    /// first. Errors opening the file are reported with their
+    /// std::generic_category() code.
+    static json parse_file(const std::string& path, std::error_code& error);
+
+    /// Parse the file at the path as a json object with options. The
+    /// borrow_strings option has no effect, since the file is unmapped once
+    /// it has been parsed.
+    static json parse_file(const std::string& path,
+                           const parse_options& options,
+                           std::error_code& error);
+
+    /// Parse the file at the path as a json object.
+    static json parse_file(const std::string& path);
+
+    /// Parse the file at the path as a json object with options.
+    static json parse_file(const std::string& path,
+                           const parse_options& options);
+
+    /// Decode a CBOR encoded value. The data must hold exactly one value.
+    /// Byte strings, tags and simple values other than false, true and null
+    /// are reported as error::decode_unsupported_type.
+    static json from_cbor(const uint8_t* data, std::size_t size,
+                          std::error_code& error);
+
+    /// Decode a CBOR encoded value.
+    static json from_cbor(const uint8_t* data, std::size_t size);
+
+    /// Decode a CBOR encoded value.
+    static json from_cbor(const std::vector<uint8_t>& data,
+                          std::error_code& error);
+
+    /// Decode a CBOR encoded value.
+    static json from_cbor(const std::vector<uint8_t>& data);
+
+    /// Decode a MessagePack encoded value. The data must hold exactly one
+    /// value. Binary and extension types are reported as
+    /// error::decode_unsupported_type.
+    static json from_msgpack(const uint8_t* data, std::size_t size,
+                             std::error_code& error);
+
+    /// Decode a MessagePack encoded value.
+    static json from_msgpack(const uint8_t* data, std::size_t size);
+
+    /// Decode a MessagePack encoded value.
+    static json from_msgpack(const std::vector<uint8_t>& data,
+                             std::error_code& error);
+
+    /// Decode a MessagePack encoded value.
+    static json from_msgpack(const std::vector<uint8_t>& data);
 
     /// Create a json array
     static json array();
     template <typename... T>
     /// Create a json array
-    static json array(T... args)
+    static json array(T&&... args)
     {
         json array = json(class_type::array);
-        array.append(args...);
+        array.append(std::forward<T>(args)...);
         return array;
     }
 
@@ -383,19 +702,113 @@ public:
     static json object(std::initializer_list<json> list);
 
 private:
+    /// Creates an empty json value of the given type, with the backing data
+    /// allocated from the given arena.
+    json(class_type type, detail::arena* arena);
+
+    /// @return True if this value owns storage allocated outside of it
+    bool owns_storage() const
+    {
+        switch (m_node.m_long.m_type)
+        {
+        case class_type::object:
+        case class_type::array:
+            return true;
+        case class_type::string:
+            return m_node.m_long.m_short_size == detail::not_short;
+        default:
+            return false;
+        }
+    }
+
+    /// @return True if this is a string stored in the value itself
+    bool is_short_string() const
+    {
+        return m_node.m_long.m_short_size <= detail::short_string_capacity;
+    }
+
+    /// @return True if this is a string referring to characters it does
+    ///         not own
+    bool is_borrowed_string() const
+    {
+        return m_node.m_long.m_short_size == detail::borrowed;
+    }
+
+    /// @return The data of a value with its data in backing_data
+    detail::backing_data& internal()
+    {
+        assert(m_node.m_long.m_short_size == detail::not_short);
+        return m_node.m_long.m_internal;
+    }
+
+    /// @return The data of a value with its data in backing_data
+    const detail::backing_data& internal() const
+    {
+        assert(m_node.m_long.m_short_size == detail::not_short);
+        return m_node.m_long.m_internal;
+    }
+
+    /// @return A copy of the type and data of this value. Objects and
+    ///         arrays on the heap are shared if share is true, other storage
+    ///         is copied to the heap, except long strings which are shared
+    ///         and borrowed strings which are only shared if share is true.
+    detail::node copy_node(bool share) const;
+
+    /// @return The object of this value, copied first if it is shared with
+    ///         other values so they are not modified. The copy shares the
+    ///         values of the members.
+    object_type& writable_object();
+
+    /// @return The array of this value, copied first if it is shared with
+    ///         other values so they are not modified. The copy shares the
+    ///         elements.
+    array_type& writable_array();
+
+    /// Returns the member with the key if this is an object, or the element
+    /// at the index if this is an array, or nullptr if there is none.
+    const json* find_child(std::string_view key, std::size_t index) const;
+
+    /// @return The characters of a string value, without escaping
+    std::string_view string_value() const;
+
+    /// Sets this value to a string. Short strings are stored in the value
+    /// itself, others are allocated from the arena if one is given.
+    void set_string(std::string_view string, detail::arena* arena = nullptr);
+
+    /// Returns a view of a string argument, or the argument converted to a
+    /// std::string if it is not convertible to a view, which avoids the
+    /// temporary std::string in the common case.
+    template <typename T>
+    static auto to_string_argument(const T& s)
+    {
+        if constexpr (std::is_convertible<const T&, std::string_view>::value)
+            return std::string_view(s);
+        else
+            return std::string(s);
+    }
+
+    /// Sets this value to a string referring to the characters, which must
+    /// outlive the value. Short strings are still stored in the value
+    /// itself, which is as cheap as referring to them.
+    void set_borrowed_string(std::string_view string);
+
+    /// Sets the type of a value with its data in backing_data, without
+    /// releasing any previous data.
+    void set_long(class_type type)
+    {
+        m_node.m_long = {type, detail::not_short, detail::backing_data()};
+    }
+
     /// Clears this object - deletes the backing data and sets the type to null
     void clear();
 
     /// Updates the type of this object, and initializes the backing data based
-    /// on this.
-    void set_type(class_type type);
+    /// on this. The backing data is allocated from the arena if one is given.
+    void set_type(class_type type, detail::arena* arena = nullptr);
 
 private:
-    /// The object containing the underlying data
-    detail::backing_data m_internal;
-
-    /// The type of this object
-    class_type m_type = class_type::null;
+    /// The object containing the type and underlying data
+    detail::node m_node;
 };
 
 std::ostream& operator<<(std::ostream& os, const json& json);
@@ -0,0 +1,77 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "json_path.hpp"
+
+#include "detail/path.hpp"
+#include "detail/path_handler.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+json_path::json_path() :
+    m_plan(std::make_shared<const detail::path_plan>()), m_path("$")
+{
+}
+
+const std::string& json_path::to_string() const
+{
+    return m_path;
+}
+
+json json_path::select(const json& value) const
+{
+    json selected(class_type::array);
+    auto select = [&selected](const json& match) { selected.append(match); };
+    detail::evaluate_path(value, m_plan->m_segments, 0, select);
+    return selected;
+}
+
+json json_path::select_input(std::string_view input,
+                             std::error_code& error) const
+{
+    assert(!error);
+    detail::path_handler handler(*m_plan);
+    json::parse(input, handler, error);
+    if (error)
+        return json(class_type::array);
+    return handler.release();
+}
+
+json json_path::select_input(std::string_view input) const
+{
+    std::error_code error;
+    auto result = select_input(input, error);
+    throw_if_error(error);
+    return result;
+}
+
+json_path json_path::parse(std::string_view path, std::error_code& error)
+{
+    assert(!error);
+    auto plan = detail::parse_path(path, error);
+    if (error)
+        return json_path();
+
+    json_path result;
+    result.m_plan = std::make_shared<const detail::path_plan>(std::move(plan));
+    result.m_path = std::string(path);
+    return result;
+}
+
+json_path json_path::parse(std::string_view path)
+{
+    std::error_code error;
+    auto result = parse(path, error);
+    throw_if_error(error);
+    return result;
+}
+}
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+struct path_plan;
+}
+
+/// A JSONPath query, compiled once to select values from many json values
+/// or inputs.
+///
+/// The supported subset of JSONPath is:
+///
+///     $               The root value
+///     .name ['name']  The member with the name
+///     .* [*]          All members or elements
+///     ..              The selector which follows selects from the value and
+///                     all its descendants, e.g. $..id or $..[0]
+///     [3] [-1]        The element at the index, counting from the end if
+///                     the index is negative
+///     [start:end:step] The elements of a slice, as in Python
+///     [?(@.a.b > 3)]  The members or elements for which the comparison
+///                     holds, with ==, !=, <, <=, > or >= and a number,
+///                     string, true, false or null. [?(@.a)] selects those
+///                     with the member.
+///
+///     auto path = bourne::json_path::parse("$.events[?(@.severity > 3)].id");
+///     bourne::json ids = path.select(events);
+///
+/// select_input() evaluates the query while parsing the input, and only
+/// builds the values which may be selected, so a selective query over a
+/// large input does not build its whole value.
+class json_path
+{
+public:
+    /// Creates the path "$", which selects the root value.
+    json_path();
+
+    /// Returns this path as it was parsed.
+    const std::string& to_string() const;
+
+    /// Returns an array of the values this path selects in the value.
+    json select(const json& value) const;
+
+    /// Parses the input and returns an array of the values this path
+    /// selects in it. Only the values which are selected, and the members
+    /// or elements a filter is tested on, are built. The values are those
+    /// select() returns for the parsed input, also for objects with
+    /// duplicate keys, of which only the last member is selected from. They
+    /// are in the order they start in the input, while select() returns the
+    /// members of objects in the order of their keys.
+    json select_input(std::string_view input, std::error_code& error) const;
+
+    /// Parses the input and returns an array of the values this path
+    /// selects in it.
+    json select_input(std::string_view input) const;
+
+    /// Compiles a JSONPath. Fails with bourne::error::path_invalid_syntax
+    /// if the path is invalid or uses JSONPath not in the supported subset.
+    static json_path parse(std::string_view path, std::error_code& error);
+
+    /// Compiles a JSONPath.
+    static json_path parse(std::string_view path);
+
+private:
+    /// The compiled path, which is shared by copies of the path since it is
+    /// not modified
+    std::shared_ptr<const detail::path_plan> m_plan;
+
+    std::string m_path;
+};
+}
+}
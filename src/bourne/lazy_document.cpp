@@ -0,0 +1,76 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "lazy_document.hpp"
+
+#include "detail/lazy_index.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+lazy_document::lazy_document() : lazy_document(parse("null"))
+{
+}
+
+lazy_document::lazy_document(std::unique_ptr<detail::lazy_index> index) :
+    m_index(std::move(index))
+{
+}
+
+lazy_document::lazy_document(lazy_document&& other) noexcept :
+    m_index(std::move(other.m_index))
+{
+}
+
+lazy_document& lazy_document::operator=(lazy_document&& other) noexcept
+{
+    m_index = std::move(other.m_index);
+    return *this;
+}
+
+lazy_document::~lazy_document()
+{
+}
+
+lazy_value lazy_document::root() const
+{
+    assert(m_index && "The document has been moved from");
+    return lazy_value(m_index.get(), 0);
+}
+
+lazy_document lazy_document::parse(std::string_view input,
+                                   std::error_code& error)
+{
+    assert(!error);
+    std::unique_ptr<detail::lazy_index> index(
+        new detail::lazy_index(input, error));
+    return lazy_document(std::move(index));
+}
+
+lazy_document lazy_document::parse(std::string_view input)
+{
+    std::error_code error;
+    auto result = parse(input, error);
+    throw_if_error(error);
+    return result;
+}
+
+lazy_document lazy_document::parse(const char* data, std::size_t size,
+                                   std::error_code& error)
+{
+    return parse(std::string_view(data, size), error);
+}
+
+lazy_document lazy_document::parse(const char* data, std::size_t size)
+{
+    return parse(std::string_view(data, size));
+}
+}
+}
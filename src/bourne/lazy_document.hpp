@@ -0,0 +1,78 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+#include "lazy_value.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+class lazy_index;
+}
+
+/// A json document which is parsed as it is read.
+///
+/// Parsing validates the input and indexes its structure, without building
+/// any values. Reading a value through root() then finds it using the
+/// index, skipping the objects and arrays it is not nested in, and only
+/// parses the value itself. Reading a few values of a large input is
+/// therefore much cheaper than parsing it into a json value.
+///
+///     auto document = bourne::lazy_document::parse(input);
+///     auto id = document.root()["meta"]["id"].to_int();
+///
+/// The document refers to the input, which must outlive it.
+class lazy_document
+{
+public:
+    /// Creates an empty document with a null root value.
+    lazy_document();
+
+    /// Move constructor.
+    lazy_document(lazy_document&& other) noexcept;
+
+    /// Move assignment operator.
+    lazy_document& operator=(lazy_document&& other) noexcept;
+
+    /// Destructor
+    ~lazy_document();
+
+    /// Returns the root value of this document.
+    lazy_value root() const;
+
+    /// Parse a string as a lazy document. If the input is not valid json
+    /// the root value is null.
+    static lazy_document parse(std::string_view input, std::error_code& error);
+
+    /// Parse a string as a lazy document.
+    static lazy_document parse(std::string_view input);
+
+    /// Parse the size bytes at data as a lazy document.
+    static lazy_document parse(const char* data, std::size_t size,
+                               std::error_code& error);
+
+    /// Parse the size bytes at data as a lazy document.
+    static lazy_document parse(const char* data, std::size_t size);
+
+private:
+    explicit lazy_document(std::unique_ptr<detail::lazy_index> index);
+
+private:
+    /// The index is kept on the heap, so values found in the document stay
+    /// valid when it is moved.
+    std::unique_ptr<detail::lazy_index> m_index;
+};
+}
+}
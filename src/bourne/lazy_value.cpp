@@ -0,0 +1,283 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "lazy_value.hpp"
+
+#include "detail/lazy_index.hpp"
+#include "detail/parser.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+lazy_value::lazy_value(const detail::lazy_index* index, uint32_t position) :
+    m_index(index), m_position(position)
+{
+    assert(m_index != nullptr);
+}
+
+class_type lazy_value::json_type() const
+{
+    switch (m_index->first_byte(m_position))
+    {
+    case '{':
+        return class_type::object;
+    case '[':
+        return class_type::array;
+    case '\"':
+        return class_type::string;
+    case 't':
+    case 'f':
+        return class_type::boolean;
+    case 'n':
+        return class_type::null;
+    default:
+        // Numbers are parsed to tell integers from floating point values
+        return to_json().json_type();
+    }
+}
+
+bool lazy_value::is_null() const
+{
+    return json_type() == class_type::null;
+}
+
+bool lazy_value::is_bool() const
+{
+    return json_type() == class_type::boolean;
+}
+
+bool lazy_value::is_int() const
+{
+    return json_type() == class_type::integral;
+}
+
+bool lazy_value::is_float() const
+{
+    // Finding the type of a number parses it, so it is only done once
+    const class_type type = json_type();
+    return type == class_type::floating || type == class_type::integral;
+}
+
+bool lazy_value::is_string() const
+{
+    return json_type() == class_type::string;
+}
+
+bool lazy_value::is_object() const
+{
+    return json_type() == class_type::object;
+}
+
+bool lazy_value::is_array() const
+{
+    return json_type() == class_type::array;
+}
+
+std::size_t lazy_value::size() const
+{
+    assert(is_array() || is_object());
+    std::size_t size = 0;
+    if (is_object())
+    {
+        for (auto member = m_index->first_member(m_position); member != 0;
+             member = m_index->next_member(member))
+        {
+            size++;
+        }
+    }
+    else
+    {
+        for (auto element = m_index->first_element(m_position); element != 0;
+             element = m_index->next_element(element))
+        {
+            size++;
+        }
+    }
+    return size;
+}
+
+lazy_value::range<lazy_value::element_iterator>
+lazy_value::array_range() const
+{
+    assert(is_array());
+    return range<element_iterator>(
+        element_iterator(m_index, m_index->first_element(m_position)),
+        element_iterator(m_index, 0));
+}
+
+lazy_value::range<lazy_value::member_iterator>
+lazy_value::object_range() const
+{
+    assert(is_object());
+    return range<member_iterator>(
+        member_iterator(m_index, m_index->first_member(m_position)),
+        member_iterator(m_index, 0));
+}
+
+bool lazy_value::has_key(std::string_view key) const
+{
+    return find(key) != 0;
+}
+
+std::vector<std::string> lazy_value::keys() const
+{
+    assert(is_object());
+    std::vector<std::string> keys;
+    for (auto member = m_index->first_member(m_position); member != 0;
+         member = m_index->next_member(member))
+    {
+        keys.push_back(m_index->key(member));
+    }
+    return keys;
+}
+
+lazy_value lazy_value::operator[](std::string_view key) const
+{
+    uint32_t position = find(key);
+    assert(position != 0);
+    return lazy_value(m_index, position);
+}
+
+lazy_value lazy_value::operator[](std::size_t index) const
+{
+    uint32_t position = find(index);
+    assert(position != 0);
+    return lazy_value(m_index, position);
+}
+
+lazy_value lazy_value::at(std::string_view key) const
+{
+    uint32_t position = find(key);
+    if (position == 0)
+        throw std::out_of_range("lazy_value::at");
+    return lazy_value(m_index, position);
+}
+
+lazy_value lazy_value::at(std::size_t index) const
+{
+    uint32_t position = find(index);
+    if (position == 0)
+        throw std::out_of_range("lazy_value::at");
+    return lazy_value(m_index, position);
+}
+
+bool lazy_value::to_bool() const
+{
+    return to_json().to_bool();
+}
+
+int64_t lazy_value::to_int() const
+{
+    return to_json().to_int();
+}
+
+double lazy_value::to_float() const
+{
+    return to_json().to_float();
+}
+
+std::string lazy_value::to_string() const
+{
+    return to_json().to_string();
+}
+
+json lazy_value::to_json() const
+{
+    // The input has been validated, so parsing a part of it cannot fail
+    return detail::parser::parse(text());
+}
+
+std::string_view lazy_value::text() const
+{
+    return m_index->text(m_position);
+}
+
+uint32_t lazy_value::find(std::string_view key) const
+{
+    assert(is_object());
+
+    // The whole object is searched since the last duplicate key is the one
+    // found
+    uint32_t found = 0;
+    for (auto member = m_index->first_member(m_position); member != 0;
+         member = m_index->next_member(member))
+    {
+        if (m_index->key_equals(member, key))
+            found = m_index->member_value(member);
+    }
+    return found;
+}
+
+lazy_value::element_iterator::element_iterator(
+    const detail::lazy_index* index, uint32_t position) :
+    m_index(index), m_position(position)
+{
+}
+
+lazy_value lazy_value::element_iterator::operator*() const
+{
+    assert(m_position != 0);
+    return lazy_value(m_index, m_position);
+}
+
+lazy_value::element_iterator& lazy_value::element_iterator::operator++()
+{
+    assert(m_position != 0);
+    m_position = m_index->next_element(m_position);
+    return *this;
+}
+
+lazy_value::element_iterator lazy_value::element_iterator::operator++(int)
+{
+    element_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+lazy_value::member_iterator::member_iterator(const detail::lazy_index* index,
+                                             uint32_t position) :
+    m_index(index), m_position(position)
+{
+}
+
+lazy_value::member_iterator::value_type
+lazy_value::member_iterator::operator*() const
+{
+    assert(m_position != 0);
+    return value_type(m_index->key(m_position),
+                      lazy_value(m_index, m_index->member_value(m_position)));
+}
+
+lazy_value::member_iterator& lazy_value::member_iterator::operator++()
+{
+    assert(m_position != 0);
+    m_position = m_index->next_member(m_position);
+    return *this;
+}
+
+lazy_value::member_iterator lazy_value::member_iterator::operator++(int)
+{
+    member_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+uint32_t lazy_value::find(std::size_t index) const
+{
+    assert(is_array());
+    for (auto element = m_index->first_element(m_position); element != 0;
+         element = m_index->next_element(element))
+    {
+        if (index-- == 0)
+            return element;
+    }
+    return 0;
+}
+}
+}
@@ -0,0 +1,258 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "class_type.hpp"
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+class lazy_index;
+}
+
+class lazy_document;
+
+/// A value of a lazy_document, which refers to the value in the input
+/// instead of holding a parsed copy of it.
+///
+/// Looking up members and elements only visits the values of the object or
+/// array itself, nested objects and arrays are skipped without reading
+/// them. Values are parsed when they are read with to_bool(), to_int(),
+/// to_float(), to_string() or to_json().
+///
+/// A value is valid as long as the document it was found in, also when the
+/// document is moved.
+///
+/// An element is found by visiting the elements before it, so size(), at()
+/// and operator[] with an index take linear time. Use array_range() and
+/// object_range() to visit all elements or members in a single pass.
+class lazy_value
+{
+public:
+    /// Iterator over the elements of an array, which visits each element
+    /// once. The elements are lazy values made when dereferenced.
+    class element_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = lazy_value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = lazy_value;
+
+        lazy_value operator*() const;
+
+        element_iterator& operator++();
+
+        element_iterator operator++(int);
+
+        bool operator==(const element_iterator& other) const
+        {
+            return m_position == other.m_position;
+        }
+
+        bool operator!=(const element_iterator& other) const
+        {
+            return m_position != other.m_position;
+        }
+
+    private:
+        friend class lazy_value;
+
+        element_iterator(const detail::lazy_index* index, uint32_t position);
+
+    private:
+        const detail::lazy_index* m_index;
+
+        /// The position of the element, zero past the last one
+        uint32_t m_position;
+    };
+
+    /// Iterator over the members of an object in the order of the input,
+    /// including the members with duplicate keys. The members are pairs of
+    /// the key and the value made when dereferenced.
+    class member_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<std::string, lazy_value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        value_type operator*() const;
+
+        member_iterator& operator++();
+
+        member_iterator operator++(int);
+
+        bool operator==(const member_iterator& other) const
+        {
+            return m_position == other.m_position;
+        }
+
+        bool operator!=(const member_iterator& other) const
+        {
+            return m_position != other.m_position;
+        }
+
+    private:
+        friend class lazy_value;
+
+        member_iterator(const detail::lazy_index* index, uint32_t position);
+
+    private:
+        const detail::lazy_index* m_index;
+
+        /// The position of the member, zero past the last one
+        uint32_t m_position;
+    };
+
+    /// The elements or members of a value, for use in range based for loops
+    template <class Iterator>
+    class range
+    {
+    public:
+        Iterator begin() const
+        {
+            return m_begin;
+        }
+
+        Iterator end() const
+        {
+            return m_end;
+        }
+
+    private:
+        friend class lazy_value;
+
+        range(Iterator begin, Iterator end) : m_begin(begin), m_end(end)
+        {
+        }
+
+    private:
+        Iterator m_begin;
+        Iterator m_end;
+    };
+
+    /// Returns the type of this value.
+    class_type json_type() const;
+
+    /// Returns true if this value is a null value
+    bool is_null() const;
+
+    /// Returns true if this value is a boolean value
+    bool is_bool() const;
+
+    /// Returns true if this value is a integer value
+    bool is_int() const;
+
+    /// Returns true if this value is a floating point value
+    bool is_float() const;
+
+    /// Returns true if this value is a string value
+    bool is_string() const;
+
+    /// Returns true if this value is a object value
+    bool is_object() const;
+
+    /// Returns true if this value is a array value
+    bool is_array() const;
+
+    /// Returns the number of elements in this object or array. If this is
+    /// not an object or array, an assert will be triggered.
+    std::size_t size() const;
+
+    /// Returns true if the key is available. This functions assumes this
+    /// value is an object.
+    bool has_key(std::string_view key) const;
+
+    /// Returns the keys of this object. This functions assumes this value is
+    /// an object.
+    std::vector<std::string> keys() const;
+
+    /// Access operator for keys, this assumes the value is an object with
+    /// the key. Of duplicate keys the last one is found, like json::parse()
+    /// keeps.
+    lazy_value operator[](std::string_view key) const;
+
+    /// Access operator for index, this assumes the value is an array with
+    /// the index.
+    lazy_value operator[](std::size_t index) const;
+
+    /// Returns the value of the member with the given key. Throws
+    /// std::out_of_range if there is none.
+    lazy_value at(std::string_view key) const;
+
+    /// Returns the element at the given index. Throws std::out_of_range if
+    /// there is none.
+    lazy_value at(std::size_t index) const;
+
+    /// Returns an iterable range of the elements. If this is not an array
+    /// value an assert is triggered.
+    range<element_iterator> array_range() const;
+
+    /// Returns an iterable range of the members. If this is not an object
+    /// value an assert is triggered.
+    range<member_iterator> object_range() const;
+
+    /// Returns the underlying boolean value of this value. If this is not a
+    /// boolean value an assert is triggered.
+    bool to_bool() const;
+
+    /// Returns the underlying integer value of this value. If this is not a
+    /// interger value an assert is triggered.
+    int64_t to_int() const;
+
+    /// Returns the underlying floating point value of this value. If this is
+    /// not a floating point value an assert is triggered.
+    double to_float() const;
+
+    /// Returns the underlying string value of this value, escaped as by
+    /// json::to_string(). If this is not a string value an assert is
+    /// triggered.
+    std::string to_string() const;
+
+    /// Parses this value with everything nested in it into a json value.
+    json to_json() const;
+
+    /// Returns the json text of this value as it is in the input.
+    std::string_view text() const;
+
+private:
+    friend class lazy_document;
+
+    lazy_value(const detail::lazy_index* index, uint32_t position);
+
+    /// @return The position of the value of the member with the key, or zero
+    ///         if there is none
+    uint32_t find(std::string_view key) const;
+
+    /// @return The position of the element at the index, or zero if there
+    ///         is none
+    uint32_t find(std::size_t index) const;
+
+private:
+    const detail::lazy_index* m_index;
+
+    /// The position of the value in the index
+    uint32_t m_position;
+};
+}
+}
@@ -0,0 +1,160 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "ndjson_parser.hpp"
+
+#include "detail/parser.hpp"
+#include "detail/simd.hpp"
+#include "detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <future>
+#include <thread>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace
+{
+/// The number of chunks parsed ahead of the records delivered, per thread
+const std::size_t chunks_ahead = 2;
+
+std::size_t thread_count(std::size_t threads)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    return std::max<std::size_t>(threads, 1);
+}
+
+bool is_blank(std::string_view line)
+{
+    return std::all_of(line.begin(), line.end(), detail::is_white_space);
+}
+}
+
+ndjson_parser::ndjson_parser() : ndjson_parser(options{})
+{
+}
+
+ndjson_parser::ndjson_parser(const options& options) : m_options(options)
+{
+    assert(m_options.chunk_size > 0);
+    const std::size_t threads = thread_count(m_options.threads);
+    if (threads > 1)
+        m_pool.reset(new detail::thread_pool(threads));
+}
+
+ndjson_parser::~ndjson_parser()
+{
+}
+
+void ndjson_parser::parse(std::string_view input,
+                          const record_function& function)
+{
+    // The lines of the chunks delivered so far
+    std::size_t lines = 0;
+    auto deliver = [&](chunk&& chunk)
+    {
+        for (auto& record : chunk.m_records)
+        {
+            record.line += lines;
+            function(std::move(record));
+        }
+        lines += chunk.m_lines;
+    };
+
+    std::size_t offset = 0;
+    if (!m_pool)
+    {
+        while (offset < input.size())
+        {
+            auto part = next_chunk(input, offset);
+            offset += part.size();
+            deliver(parse_chunk(part));
+        }
+        return;
+    }
+
+    std::deque<std::future<chunk>> pending;
+    try
+    {
+        while (offset < input.size() || !pending.empty())
+        {
+            while (offset < input.size() &&
+                   pending.size() < m_pool->size() * chunks_ahead)
+            {
+                auto part = next_chunk(input, offset);
+                offset += part.size();
+                auto parse = [this, part]() { return parse_chunk(part); };
+                pending.push_back(m_pool->submit(parse));
+            }
+
+            auto next = std::move(pending.front());
+            pending.pop_front();
+            deliver(next.get());
+        }
+    }
+    catch (...)
+    {
+        // The chunks still being parsed refer to the input
+        for (auto& chunk : pending)
+        {
+            chunk.wait();
+        }
+        throw;
+    }
+}
+
+std::vector<ndjson_parser::record> ndjson_parser::parse(std::string_view input)
+{
+    std::vector<record> records;
+    parse(input, [&records](record&& record)
+          { records.push_back(std::move(record)); });
+    return records;
+}
+
+ndjson_parser::chunk ndjson_parser::parse_chunk(std::string_view input) const
+{
+    chunk result;
+    std::size_t offset = 0;
+    while (offset < input.size())
+    {
+        std::size_t end = input.find('\n', offset);
+        if (end == std::string_view::npos)
+            end = input.size();
+
+        auto line = input.substr(offset, end - offset);
+        offset = end + 1;
+        result.m_lines++;
+        if (is_blank(line))
+            continue;
+
+        std::error_code error;
+        json value =
+            detail::parser::parse(line, m_options.parse_options, error);
+        result.m_records.push_back({result.m_lines, std::move(value), error});
+    }
+    return result;
+}
+
+std::string_view ndjson_parser::next_chunk(std::string_view input,
+                                           std::size_t offset) const
+{
+    assert(offset < input.size());
+    if (input.size() - offset <= m_options.chunk_size)
+        return input.substr(offset);
+
+    // The chunk includes the line break ending its last line
+    std::size_t end = input.find('\n', offset + m_options.chunk_size - 1);
+    if (end == std::string_view::npos)
+        return input.substr(offset);
+    return input.substr(offset, end + 1 - offset);
+}
+}
+}
@@ -0,0 +1,124 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+class thread_pool;
+}
+
+/// Parser for newline delimited json (NDJSON or JSON Lines), where every
+/// line of the input is a json value.
+///
+/// The input is split into chunks ending at line breaks, which are parsed in
+/// parallel by a pool of threads. The records are delivered in the order of
+/// the lines, each with its value or the error found parsing it, so an
+/// invalid line does not stop the lines following it from being parsed.
+/// Empty lines and lines with only white space are skipped.
+///
+///     bourne::ndjson_parser parser;
+///     parser.parse(input, [](bourne::ndjson_parser::record&& record)
+///     {
+///         if (!record.error)
+///             store(std::move(record.value));
+///     });
+///
+/// The threads are started by the constructor and reused by every parse.
+class ndjson_parser
+{
+public:
+    struct options
+    {
+        /// The options used to parse every line
+        json::parse_options parse_options;
+
+        /// The number of threads to parse with, zero uses one per core. With
+        /// one thread the input is parsed by the calling thread.
+        std::size_t threads = 0;
+
+        /// The number of bytes of input a thread parses at a time. Chunks
+        /// are extended to end at a line break, so lines are never split.
+        std::size_t chunk_size = 1024 * 1024;
+    };
+
+    /// A parsed line of the input
+    struct record
+    {
+        /// The number of the line in the input, starting from one
+        std::size_t line;
+
+        /// The value of the line, null if the line is invalid
+        json value;
+
+        /// The error found parsing the line
+        std::error_code error;
+    };
+
+    /// Function receiving the records in the order of the lines
+    using record_function = std::function<void(record&& record)>;
+
+    /// Creates a parser using one thread per core.
+    ndjson_parser();
+
+    /// Creates a parser with options.
+    explicit ndjson_parser(const options& options);
+
+    /// Destructor, joins the threads.
+    ~ndjson_parser();
+
+    ndjson_parser(const ndjson_parser&) = delete;
+    ndjson_parser& operator=(const ndjson_parser&) = delete;
+
+    /// Parses the input and passes every record to the function, from the
+    /// calling thread. Only a few chunks ahead of the records delivered are
+    /// parsed at any time, so the records of large inputs are not all held
+    /// in memory at once.
+    void parse(std::string_view input, const record_function& function);
+
+    /// Parses the input and returns the records in the order of the lines.
+    std::vector<record> parse(std::string_view input);
+
+private:
+    /// The records of a chunk, numbered from the start of the chunk
+    struct chunk
+    {
+        std::vector<record> m_records;
+
+        /// The number of lines of the chunk
+        std::size_t m_lines = 0;
+    };
+
+    /// Parses the lines of a chunk, which ends at a line break or the end
+    /// of the input
+    chunk parse_chunk(std::string_view input) const;
+
+    /// @return The chunk of the input starting at the offset
+    std::string_view next_chunk(std::string_view input,
+                                std::size_t offset) const;
+
+private:
+    options m_options;
+
+    /// The threads parsing chunks, nullptr when parsing on the calling
+    /// thread
+    std::unique_ptr<detail::thread_pool> m_pool;
+};
+}
+}
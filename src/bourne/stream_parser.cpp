@@ -0,0 +1,84 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "stream_parser.hpp"
+
+#include "detail/dom_builder.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+stream_parser::stream_parser() : stream_parser(json::parse_options{})
+{
+}
+
+stream_parser::stream_parser(const json::parse_options& options) :
+    m_options(options),
+    m_builder(new detail::dom_builder(m_options, nullptr, std::string_view(),
+                                       m_error)),
+    m_parser(*m_builder, m_error)
+{
+}
+
+stream_parser::stream_parser(handler& handler) : m_parser(handler, m_error)
+{
+}
+
+stream_parser::~stream_parser()
+{
+}
+
+void stream_parser::feed(const char* data, std::size_t size,
+                         std::error_code& error)
+{
+    assert(!error);
+    assert(!m_finished && "The input has already been finished");
+    if (!m_error)
+        m_parser.feed(data, size);
+    error = m_error;
+}
+
+void stream_parser::feed(const char* data, std::size_t size)
+{
+    std::error_code error;
+    feed(data, size, error);
+    throw_if_error(error);
+}
+
+void stream_parser::finish(std::error_code& error)
+{
+    assert(!error);
+    if (!m_finished)
+    {
+        m_finished = true;
+        m_parser.finish();
+    }
+    error = m_error;
+}
+
+void stream_parser::finish()
+{
+    std::error_code error;
+    finish(error);
+    throw_if_error(error);
+}
+
+bool stream_parser::is_complete() const
+{
+    return m_parser.is_complete();
+}
+
+json stream_parser::release()
+{
+    assert(m_builder && "The parser reports to a handler");
+    assert(m_finished && !m_error);
+    return m_builder->release();
+}
+}
+}
@@ -0,0 +1,97 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <system_error>
+
+#include "detail/push_parser.hpp"
+#include "error.hpp"
+#include "handler.hpp"
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+class dom_builder;
+}
+
+/// Parser for json input which arrives in chunks, e.g. from a socket or a
+/// pipe.
+///
+/// The input is passed to feed() as it arrives, in chunks of any size, and
+/// the parser keeps its state between the calls. Only the bytes of a single
+/// string, number or literal which is split between chunks are buffered.
+/// Once the input ends finish() completes the parse. The values and errors
+/// are the same as when parsing the whole input with json::parse().
+///
+///     bourne::stream_parser parser;
+///     while (auto size = read(socket, buffer, sizeof(buffer)))
+///         parser.feed(buffer, size);
+///     parser.finish();
+///     bourne::json value = parser.release();
+class stream_parser
+{
+public:
+    /// Creates a stream parser which builds a json value.
+    stream_parser();
+
+    /// Creates a stream parser which builds a json value, with options.
+    explicit stream_parser(const json::parse_options& options);
+
+    /// Creates a stream parser which reports the parsed values to the
+    /// handler instead of building a json value.
+    explicit stream_parser(handler& handler);
+
+    /// Destructor
+    ~stream_parser();
+
+    stream_parser(const stream_parser&) = delete;
+    stream_parser& operator=(const stream_parser&) = delete;
+
+    /// Parse the next chunk of the input. Once an error has been reported
+    /// the rest of the input is ignored and the same error is reported again.
+    void feed(const char* data, std::size_t size, std::error_code& error);
+
+    /// Parse the next chunk of the input.
+    void feed(const char* data, std::size_t size);
+
+    /// Complete parsing at the end of the input. Reports an error if the
+    /// input ended before the value was complete.
+    void finish(std::error_code& error);
+
+    /// Complete parsing at the end of the input.
+    void finish();
+
+    /// Returns true when a complete value has been parsed. Only white space
+    /// may follow it. Note that a number at the end of the input is only
+    /// complete once the byte following it has been seen.
+    bool is_complete() const;
+
+    /// Returns the parsed json value, which is moved out of the parser. Must
+    /// only be called after finish() succeeded on a parser building a json
+    /// value.
+    json release();
+
+private:
+    std::error_code m_error;
+    json::parse_options m_options;
+
+    /// Builds the json value, nullptr when reporting to a user handler
+    std::unique_ptr<detail::dom_builder> m_builder;
+
+    detail::push_parser m_parser;
+
+    /// Set once finish() has been called
+    bool m_finished = false;
+};
+}
+}
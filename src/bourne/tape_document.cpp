@@ -0,0 +1,123 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "tape_document.hpp"
+
+#include "detail/mapped_file.hpp"
+#include "detail/tape.hpp"
+#include "detail/throw_if_error.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+tape_document::tape_document() : tape_document(json(nullptr).to_tape())
+{
+}
+
+tape_document::tape_document(std::vector<uint8_t> buffer) :
+    m_buffer(std::move(buffer)), m_data(m_buffer.data()),
+    m_size(m_buffer.size())
+{
+}
+
+tape_document::tape_document(const uint8_t* data, std::size_t size) :
+    m_data(data), m_size(size)
+{
+}
+
+tape_document::tape_document(tape_document&& other) noexcept :
+    m_file(std::move(other.m_file)), m_buffer(std::move(other.m_buffer)),
+    m_data(other.m_data), m_size(other.m_size)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+tape_document& tape_document::operator=(tape_document&& other) noexcept
+{
+    m_file = std::move(other.m_file);
+    m_buffer = std::move(other.m_buffer);
+    m_data = other.m_data;
+    m_size = other.m_size;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    return *this;
+}
+
+tape_document::~tape_document()
+{
+}
+
+tape_value tape_document::root() const
+{
+    assert(m_data != nullptr && "The document has been moved from");
+    return tape_value(m_data, m_size, detail::tape_view::root());
+}
+
+const uint8_t* tape_document::data() const
+{
+    return m_data;
+}
+
+std::size_t tape_document::size() const
+{
+    return m_size;
+}
+
+tape_document tape_document::from_json(const json& value)
+{
+    return tape_document(value.to_tape());
+}
+
+tape_document tape_document::open(const std::string& path,
+                                  std::error_code& error)
+{
+    assert(!error);
+    std::unique_ptr<detail::mapped_file> file(new detail::mapped_file(
+        path, error, detail::mapped_file::access::random));
+    if (error)
+        return tape_document();
+
+    const auto data = file->data();
+    auto document = load(reinterpret_cast<const uint8_t*>(data.data()),
+                         data.size(), error);
+    if (error)
+        return tape_document();
+    document.m_file = std::move(file);
+    return document;
+}
+
+tape_document tape_document::open(const std::string& path)
+{
+    std::error_code error;
+    auto result = open(path, error);
+    throw_if_error(error);
+    return result;
+}
+
+tape_document tape_document::load(const uint8_t* data, std::size_t size,
+                                  std::error_code& error)
+{
+    assert(!error);
+    detail::tape_view::check(data, size, error);
+    if (error)
+        return tape_document();
+
+    return tape_document(data, size);
+}
+
+tape_document tape_document::load(const uint8_t* data, std::size_t size)
+{
+    std::error_code error;
+    auto result = load(data, size, error);
+    throw_if_error(error);
+    return result;
+}
+}
+}
@@ -0,0 +1,104 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "json.hpp"
+#include "tape_value.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+namespace detail
+{
+class mapped_file;
+}
+
+/// A json value encoded as a binary tape, which is read where it is without
+/// decoding it.
+///
+/// The tape is a flat encoding without pointers, written by
+/// json::to_tape(). It can be stored in a file and mapped back into memory
+/// with open(), so the time to open it does not depend on its size: only
+/// the header is checked, and the values are read from the mapped pages as
+/// they are looked up through root().
+///
+///     auto tape = value.to_tape();
+///     std::ofstream file("config.tape", std::ios::binary);
+///     file.write(reinterpret_cast<const char*>(tape.data()), tape.size());
+///
+///     auto document = bourne::tape_document::open("config.tape");
+///     auto port = document.root()["server"]["port"].to_int();
+class tape_document
+{
+public:
+    /// Creates a document with a null root value.
+    tape_document();
+
+    /// Move constructor.
+    tape_document(tape_document&& other) noexcept;
+
+    /// Move assignment operator.
+    tape_document& operator=(tape_document&& other) noexcept;
+
+    /// Destructor
+    ~tape_document();
+
+    /// Returns the root value of this document.
+    tape_value root() const;
+
+    /// Returns the bytes of the tape.
+    const uint8_t* data() const;
+
+    /// Returns the size of the tape in bytes.
+    std::size_t size() const;
+
+    /// Encodes the value as a tape held by the document.
+    static tape_document from_json(const json& value);
+
+    /// Maps the tape in the file at the path into memory. Errors opening
+    /// the file are reported with their std::generic_category() code, and
+    /// files which are not tapes with bourne::error::decode_invalid_tape.
+    static tape_document open(const std::string& path, std::error_code& error);
+
+    /// Maps the tape in the file at the path into memory.
+    static tape_document open(const std::string& path);
+
+    /// Reads the tape in the size bytes at data, which must outlive the
+    /// document.
+    static tape_document load(const uint8_t* data, std::size_t size,
+                              std::error_code& error);
+
+    /// Reads the tape in the size bytes at data, which must outlive the
+    /// document.
+    static tape_document load(const uint8_t* data, std::size_t size);
+
+private:
+    explicit tape_document(std::vector<uint8_t> buffer);
+
+    tape_document(const uint8_t* data, std::size_t size);
+
+private:
+    /// The file the tape is mapped from, if any. It is kept on the heap so
+    /// values found in the document stay valid when it is moved.
+    std::unique_ptr<detail::mapped_file> m_file;
+
+    /// The tape, if it is held by the document
+    std::vector<uint8_t> m_buffer;
+
+    const uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+}
+}
@@ -0,0 +1,195 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "tape_value.hpp"
+
+#include "detail/dom_builder.hpp"
+#include "detail/serializer.hpp"
+#include "detail/tape.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <system_error>
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+tape_value::tape_value(const uint8_t* data, std::size_t size,
+                       uint64_t offset) :
+    m_data(data), m_size(size), m_offset(offset)
+{
+    assert(m_data != nullptr);
+}
+
+class_type tape_value::json_type() const
+{
+    return detail::tape_view(m_data, m_size).node(m_offset).m_type;
+}
+
+bool tape_value::is_null() const
+{
+    return json_type() == class_type::null;
+}
+
+bool tape_value::is_bool() const
+{
+    return json_type() == class_type::boolean;
+}
+
+bool tape_value::is_int() const
+{
+    return json_type() == class_type::integral;
+}
+
+bool tape_value::is_float() const
+{
+    return json_type() == class_type::floating ||
+           json_type() == class_type::integral;
+}
+
+bool tape_value::is_string() const
+{
+    return json_type() == class_type::string;
+}
+
+bool tape_value::is_object() const
+{
+    return json_type() == class_type::object;
+}
+
+bool tape_value::is_array() const
+{
+    return json_type() == class_type::array;
+}
+
+std::size_t tape_value::size() const
+{
+    assert(is_array() || is_object());
+    return detail::tape_view(m_data, m_size).node(m_offset).m_size;
+}
+
+bool tape_value::has_key(std::string_view key) const
+{
+    return find(key) != 0;
+}
+
+std::vector<std::string_view> tape_value::keys() const
+{
+    assert(is_object());
+    const detail::tape_view tape(m_data, m_size);
+    const auto node = tape.node(m_offset);
+    const uint64_t table = tape.children(m_offset, node);
+
+    std::vector<std::string_view> keys;
+    keys.reserve(node.m_size);
+    for (uint64_t i = 0; i < node.m_size; ++i)
+    {
+        const uint64_t key = table + i * detail::tape_node_size;
+        keys.push_back(tape.string(key, tape.node(key)));
+    }
+    return keys;
+}
+
+tape_value tape_value::operator[](std::string_view key) const
+{
+    uint64_t offset = find(key);
+    assert(offset != 0);
+    return tape_value(m_data, m_size, offset);
+}
+
+tape_value tape_value::operator[](std::size_t index) const
+{
+    uint64_t offset = find(index);
+    assert(offset != 0);
+    return tape_value(m_data, m_size, offset);
+}
+
+tape_value tape_value::at(std::string_view key) const
+{
+    uint64_t offset = find(key);
+    if (offset == 0)
+        throw std::out_of_range("tape_value::at");
+    return tape_value(m_data, m_size, offset);
+}
+
+tape_value tape_value::at(std::size_t index) const
+{
+    uint64_t offset = find(index);
+    if (offset == 0)
+        throw std::out_of_range("tape_value::at");
+    return tape_value(m_data, m_size, offset);
+}
+
+bool tape_value::to_bool() const
+{
+    const auto node = detail::tape_view(m_data, m_size).node(m_offset);
+    assert(node.m_type == class_type::boolean);
+    return node.m_payload != 0;
+}
+
+int64_t tape_value::to_int() const
+{
+    const auto node = detail::tape_view(m_data, m_size).node(m_offset);
+    assert(node.m_type == class_type::integral);
+    return int64_t(node.m_payload);
+}
+
+double tape_value::to_float() const
+{
+    const auto node = detail::tape_view(m_data, m_size).node(m_offset);
+    assert(is_float());
+    if (node.m_type == class_type::floating)
+    {
+        return detail::bits_double(node.m_payload);
+    }
+    else
+    {
+        return double(int64_t(node.m_payload));
+    }
+}
+
+std::string tape_value::to_string() const
+{
+    std::string output;
+    detail::string_sink sink(output);
+    detail::write_escaped(to_string_view(), sink);
+    return output;
+}
+
+std::string_view tape_value::to_string_view() const
+{
+    assert(is_string());
+    const detail::tape_view tape(m_data, m_size);
+    return tape.string(m_offset, tape.node(m_offset));
+}
+
+json tape_value::to_json() const
+{
+    std::error_code error;
+    const json::parse_options options;
+    detail::dom_builder builder(options, nullptr, std::string_view(), error);
+    detail::tape_view(m_data, m_size).report(m_offset, builder);
+    return builder.release();
+}
+
+uint64_t tape_value::find(std::string_view key) const
+{
+    assert(is_object());
+    const detail::tape_view tape(m_data, m_size);
+    return tape.find(m_offset, tape.node(m_offset), key);
+}
+
+uint64_t tape_value::find(std::size_t index) const
+{
+    assert(is_array());
+    const detail::tape_view tape(m_data, m_size);
+    const auto node = tape.node(m_offset);
+    if (index >= node.m_size)
+        return 0;
+    return tape.children(m_offset, node) + index * detail::tape_node_size;
+}
+}
+}
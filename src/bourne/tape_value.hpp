@@ -0,0 +1,136 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "class_type.hpp"
+#include "json.hpp"
+#include "version.hpp"
+
+namespace bourne
+{
+inline namespace STEINWURF_BOURNE_VERSION
+{
+class tape_document;
+
+/// A value of a tape_document, which reads the value from the tape where it
+/// is instead of decoding it.
+///
+/// Members are found by a binary search of the sorted keys of their object
+/// and elements are found directly by their index, so the cost of a lookup
+/// does not depend on the size of the values around it.
+///
+/// Reading a part of a corrupt tape throws std::system_error with
+/// bourne::error::decode_invalid_tape.
+///
+/// A value is valid as long as the tape it refers to.
+class tape_value
+{
+public:
+    /// Returns the type of this value.
+    class_type json_type() const;
+
+    /// Returns true if this value is a null value
+    bool is_null() const;
+
+    /// Returns true if this value is a boolean value
+    bool is_bool() const;
+
+    /// Returns true if this value is a integer value
+    bool is_int() const;
+
+    /// Returns true if this value is a floating point value
+    bool is_float() const;
+
+    /// Returns true if this value is a string value
+    bool is_string() const;
+
+    /// Returns true if this value is a object value
+    bool is_object() const;
+
+    /// Returns true if this value is a array value
+    bool is_array() const;
+
+    /// Returns the number of elements in this object or array. If this is
+    /// not an object or array, an assert will be triggered.
+    std::size_t size() const;
+
+    /// Returns true if the key is available. This functions assumes this
+    /// value is an object.
+    bool has_key(std::string_view key) const;
+
+    /// Returns the keys of this object in sorted order. The keys refer to
+    /// the tape. This functions assumes this value is an object.
+    std::vector<std::string_view> keys() const;
+
+    /// Access operator for keys, this assumes the value is an object with
+    /// the key.
+    tape_value operator[](std::string_view key) const;
+
+    /// Access operator for index, this assumes the value is an array with
+    /// the index.
+    tape_value operator[](std::size_t index) const;
+
+    /// Returns the value of the member with the given key. Throws
+    /// std::out_of_range if there is none.
+    tape_value at(std::string_view key) const;
+
+    /// Returns the element at the given index. Throws std::out_of_range if
+    /// there is none.
+    tape_value at(std::size_t index) const;
+
+    /// Returns the underlying boolean value of this value. If this is not a
+    /// boolean value an assert is triggered.
+    bool to_bool() const;
+
+    /// Returns the underlying integer value of this value. If this is not a
+    /// interger value an assert is triggered.
+    int64_t to_int() const;
+
+    /// Returns the underlying floating point value of this value. If this is
+    /// not a floating point value an assert is triggered.
+    double to_float() const;
+
+    /// Returns the underlying string value of this value, escaped as by
+    /// json::to_string(). If this is not a string value an assert is
+    /// triggered.
+    std::string to_string() const;
+
+    /// Returns the underlying string value of this value without escaping
+    /// it. The view refers to the tape. If this is not a string value an
+    /// assert is triggered.
+    std::string_view to_string_view() const;
+
+    /// Decodes this value with everything nested in it into a json value.
+    json to_json() const;
+
+private:
+    friend class tape_document;
+
+    tape_value(const uint8_t* data, std::size_t size, uint64_t offset);
+
+    /// @return The offset of the value of the member with the key, or zero
+    ///         if there is none
+    uint64_t find(std::string_view key) const;
+
+    /// @return The offset of the element at the index, or zero if there is
+    ///         none
+    uint64_t find(std::size_t index) const;
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+
+    /// The offset of the node of the value in the tape
+    uint64_t m_offset;
+};
+}
+}
@@ -0,0 +1,119 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_cbor, test_round_trip)
+{
+    auto value = bourne::json::parse(
+        R"({"null": null, "bool": [true, false], "int": [0, 23, 24, -1, -25,
+            65536, -9223372036854775808, 9223372036854775807],
+            "float": [1.5, 0.1, -2.0e300], "string": ["", "short",
+            "a string which is longer than twenty three bytes"],
+            "nested": {"empty_array": [], "empty_object": {}}})");
+
+    auto encoded = value.to_cbor();
+    auto decoded = bourne::json::from_cbor(encoded);
+    EXPECT_EQ(value, decoded);
+    EXPECT_TRUE(decoded["float"][0].is_float());
+    EXPECT_TRUE(decoded["int"][0].is_int());
+
+    // The output is appended to, so it can be reused
+    std::vector<uint8_t> output;
+    value.to_cbor(output);
+    value.to_cbor(output);
+    EXPECT_EQ(encoded.size() * 2, output.size());
+    output.clear();
+    value.to_cbor(output);
+    EXPECT_EQ(encoded, output);
+}
+
+TEST(test_cbor, test_encoding)
+{
+    using bytes = std::vector<uint8_t>;
+
+    EXPECT_EQ(bytes({0x00}), bourne::json(0).to_cbor());
+    EXPECT_EQ(bytes({0x17}), bourne::json(23).to_cbor());
+    EXPECT_EQ(bytes({0x18, 0x18}), bourne::json(24).to_cbor());
+    EXPECT_EQ(bytes({0x19, 0x03, 0xe8}), bourne::json(1000).to_cbor());
+    EXPECT_EQ(bytes({0x20}), bourne::json(-1).to_cbor());
+    EXPECT_EQ(bytes({0x39, 0x03, 0xe7}), bourne::json(-1000).to_cbor());
+    EXPECT_EQ(bytes({0xfa, 0x3f, 0xc0, 0x00, 0x00}),
+              bourne::json(1.5).to_cbor());
+    EXPECT_EQ(bytes({0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a}),
+              bourne::json(1.1).to_cbor());
+    EXPECT_EQ(bytes({0xf6}), bourne::json(nullptr).to_cbor());
+    EXPECT_EQ(bytes({0xf5}), bourne::json(true).to_cbor());
+    EXPECT_EQ(bytes({0x61, 0x61}), bourne::json("a").to_cbor());
+    EXPECT_EQ(bytes({0x83, 0x01, 0x02, 0x03}),
+              bourne::json::array(1, 2, 3).to_cbor());
+    EXPECT_EQ(bytes({0xa1, 0x61, 0x61, 0x01}),
+              bourne::json::parse(R"({"a": 1})").to_cbor());
+
+    // Encodings which are not written are decoded as well
+    EXPECT_EQ(1.5,
+              bourne::json::from_cbor(bytes({0xf9, 0x3e, 0x00})).to_float());
+    EXPECT_EQ(bourne::json::array(1, 2),
+              bourne::json::from_cbor(bytes({0x9f, 0x01, 0x02, 0xff})));
+    EXPECT_EQ("streaming",
+              bourne::json::from_cbor(bytes({0x7f, 0x65, 0x73, 0x74, 0x72,
+                                             0x65, 0x61, 0x64, 0x6d, 0x69,
+                                             0x6e, 0x67, 0xff}))
+                  .to_string());
+    EXPECT_EQ(bourne::json::parse(R"({"a": 1})"),
+              bourne::json::from_cbor(bytes({0xbf, 0x61, 0x61, 0x01, 0xff})));
+
+    // Integers which do not fit in an int64_t are decoded as floating point
+    auto large = bourne::json::from_cbor(
+        bytes({0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+    EXPECT_TRUE(large.is_float());
+    EXPECT_DOUBLE_EQ(18446744073709551615.0, large.to_float());
+}
+
+TEST(test_cbor, test_errors)
+{
+    using bytes = std::vector<uint8_t>;
+
+    auto decode = [](const bytes& data)
+    {
+        std::error_code error;
+        auto value = bourne::json::from_cbor(data, error);
+        EXPECT_TRUE(value.is_null());
+        return error;
+    };
+
+    EXPECT_EQ(bourne::error::decode_unexpected_end, decode(bytes()));
+    EXPECT_EQ(bourne::error::decode_unexpected_end, decode(bytes({0x19})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0x83, 0x01, 0x02})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0x9f, 0x01})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0x65, 0x61})));
+    EXPECT_EQ(bourne::error::decode_trailing_bytes,
+              decode(bytes({0x01, 0x02})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type,
+              decode(bytes({0x41, 0x00})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type,
+              decode(bytes({0xc1, 0x00})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type, decode(bytes({0xf7})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type, decode(bytes({0xff})));
+    EXPECT_EQ(bourne::error::decode_key_not_string,
+              decode(bytes({0xa1, 0x01, 0x01})));
+
+    // A huge size in a truncated input does not allocate
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                            0xff, 0x01})));
+
+    EXPECT_THROW(bourne::json::from_cbor(bytes({0x19})), std::system_error);
+}
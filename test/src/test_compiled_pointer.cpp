@@ -0,0 +1,115 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <string>
+#include <system_error>
+
+#include <bourne/compiled_pointer.hpp>
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+// The example document of RFC 6901 section 5
+const char* input = R"({
+    "foo": ["bar", "baz"],
+    "": 0,
+    "a/b": 1,
+    "c%d": 2,
+    "e^f": 3,
+    "g|h": 4,
+    "i\\j": 5,
+    "k\"l": 6,
+    " ": 7,
+    "m~n": 8
+})";
+}
+
+TEST(test_compiled_pointer, test_rfc_examples)
+{
+    const auto value = bourne::json::parse(input);
+
+    EXPECT_EQ(value, value.at_pointer(""));
+    EXPECT_EQ(bourne::json::array("bar", "baz"), value.at_pointer("/foo"));
+    EXPECT_EQ("bar", value.at_pointer("/foo/0").to_string_view());
+    EXPECT_EQ(0, value.at_pointer("/").to_int());
+    EXPECT_EQ(1, value.at_pointer("/a~1b").to_int());
+    EXPECT_EQ(2, value.at_pointer("/c%d").to_int());
+    EXPECT_EQ(3, value.at_pointer("/e^f").to_int());
+    EXPECT_EQ(4, value.at_pointer("/g|h").to_int());
+    EXPECT_EQ(5, value.at_pointer("/i\\j").to_int());
+    EXPECT_EQ(6, value.at_pointer("/k\"l").to_int());
+    EXPECT_EQ(7, value.at_pointer("/ ").to_int());
+    EXPECT_EQ(8, value.at_pointer("/m~0n").to_int());
+
+    auto pointer = bourne::compiled_pointer::parse("/m~0n");
+    EXPECT_EQ(1U, pointer.size());
+    EXPECT_EQ("/m~0n", pointer.to_string());
+    EXPECT_EQ(8, value.at_pointer(pointer).to_int());
+
+    EXPECT_EQ(value, value.at_pointer(bourne::compiled_pointer()));
+}
+
+TEST(test_compiled_pointer, test_nested)
+{
+    auto value = bourne::json::parse(
+        R"({"a": {"b": [0, 1, 2, {"c": "found"}]}, "10": {"0": "key"}})");
+    auto pointer = bourne::compiled_pointer::parse("/a/b/3/c");
+    EXPECT_EQ(4U, pointer.size());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ("found", value.at_pointer(pointer).to_string_view());
+    }
+    EXPECT_EQ("found", value.at_pointer("/a/b/3/c").to_string_view());
+
+    // Tokens which look like indices are keys of objects
+    EXPECT_EQ("key", value.at_pointer("/10/0").to_string_view());
+}
+
+TEST(test_compiled_pointer, test_errors)
+{
+    const auto value = bourne::json::parse(input);
+
+    for (const char* pointer : {"/missing", "/foo/2", "/foo/-", "/foo/01",
+                                "/foo/bar", "/foo/0/bar", "/ /0",
+                                "/foo/18446744073709551616"})
+    {
+        SCOPED_TRACE(pointer);
+        std::error_code error;
+        EXPECT_TRUE(value.at_pointer(pointer, error).is_null());
+        EXPECT_EQ(bourne::error::pointer_not_found, error);
+        EXPECT_THROW(value.at_pointer(pointer), std::system_error);
+
+        error.clear();
+        auto compiled = bourne::compiled_pointer::parse(pointer, error);
+        ASSERT_FALSE(error);
+        EXPECT_TRUE(value.at_pointer(compiled, error).is_null());
+        EXPECT_EQ(bourne::error::pointer_not_found, error);
+    }
+
+    for (const char* pointer : {"foo", "/m~2n", "/m~", "/missing/~"})
+    {
+        SCOPED_TRACE(pointer);
+        std::error_code error;
+        EXPECT_TRUE(value.at_pointer(pointer, error).is_null());
+        EXPECT_EQ(bourne::error::pointer_invalid_syntax, error);
+
+        error.clear();
+        auto compiled = bourne::compiled_pointer::parse(pointer, error);
+        EXPECT_EQ(bourne::error::pointer_invalid_syntax, error);
+        EXPECT_EQ(0U, compiled.size());
+        EXPECT_THROW(bourne::compiled_pointer::parse(pointer),
+                     std::system_error);
+    }
+
+    // Lookups never insert the members they do not find
+    auto copy = value;
+    std::error_code error;
+    copy.at_pointer("/missing/value", error);
+    EXPECT_EQ(bourne::error::pointer_not_found, error);
+    EXPECT_EQ(value.size(), copy.size());
+}
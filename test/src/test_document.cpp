@@ -0,0 +1,108 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <bourne/document.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_document, test_parse)
+{
+    std::string json_string =
+        "{\"key1\":\"value\",\"key2\":true,\"key3\":[1,2.5,\"three\",null],"
+        "\"a key which is too long for the small string optimization\":"
+        "{\"nested\":{}}}";
+
+    std::error_code error;
+    auto document = bourne::document::parse(json_string, error);
+    ASSERT_FALSE((bool)error);
+    EXPECT_LT(0U, document.arena_capacity());
+
+    const bourne::json& root = document.root();
+    ASSERT_TRUE(root.is_object());
+    EXPECT_EQ("value", root["key1"].to_string());
+    EXPECT_TRUE(root["key2"].to_bool());
+    EXPECT_EQ(4U, root["key3"].size());
+    EXPECT_EQ("three", root["key3"][2].to_string());
+    EXPECT_EQ(bourne::json::parse(json_string), root);
+}
+
+TEST(test_document, test_parse_file)
+{
+    std::ifstream test_json("test.json");
+    EXPECT_TRUE(test_json.is_open());
+
+    std::stringstream buffer;
+    buffer << test_json.rdbuf();
+
+    auto document = bourne::document::parse(buffer.str());
+    EXPECT_EQ("Jørgen", document.root()["danish_name"].to_string());
+    EXPECT_EQ("值", document.root()["键"].to_string());
+
+    // Parsing the mapped file gives the same document
+    bourne::json::parse_options options;
+    options.borrow_strings = true;
+    auto mapped = bourne::document::parse_file("test.json", options);
+    EXPECT_EQ(document.root(), mapped.root());
+}
+
+TEST(test_document, test_copy_outlives_document)
+{
+    bourne::json copy;
+    {
+        auto document =
+            bourne::document::parse("{\"array\":[\"a\",{\"b\":\"c\"}]}");
+        copy = document.root()["array"];
+    }
+    EXPECT_EQ(bourne::json::array("a", bourne::json({"b", "c"})), copy);
+
+    // The copy is a regular json value which can be modified
+    copy.append("d");
+    copy[1]["e"] = "f";
+    EXPECT_EQ("[\"a\",{\"b\":\"c\",\"e\":\"f\"},\"d\"]", copy.dump_min());
+}
+
+TEST(test_document, test_borrow_strings)
+{
+    std::string input = "{\"a key longer than inline keys\": "
+                        "\"a string without escapes\"}";
+
+    bourne::json::parse_options options;
+    options.borrow_strings = true;
+    auto document = bourne::document::parse(input, options);
+
+    // The strings refer to the copy of the input kept by the document
+    input.assign(input.size(), ' ');
+    EXPECT_EQ("a string without escapes",
+              document.root()["a key longer than inline keys"].to_string());
+}
+
+TEST(test_document, test_move)
+{
+    auto document = bourne::document::parse("[1,\"two\",[3]]");
+    bourne::document other = std::move(document);
+    EXPECT_EQ("[1,\"two\",[3]]", other.root().dump_min());
+
+    document = bourne::document::parse("{\"four\":4}");
+    other = std::move(document);
+    EXPECT_EQ(4, other.root()["four"].to_int());
+}
+
+TEST(test_document, test_parse_error)
+{
+    std::error_code error;
+    auto document = bourne::document::parse("{\"bourne\": [0 0}", error);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              error);
+    EXPECT_TRUE(document.root().is_null());
+
+    bourne::json::parse_options options;
+    options.strict = true;
+    EXPECT_THROW(bourne::document::parse("{\"a\":1,\"a\":2}", options),
+                 std::system_error);
+}
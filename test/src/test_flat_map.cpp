@@ -0,0 +1,95 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bourne/detail/flat_map.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+using map_type =
+    bourne::detail::flat_map<std::string, int,
+                             std::allocator<std::pair<const std::string, int>>>;
+
+std::vector<std::string> keys(const map_type& map)
+{
+    std::vector<std::string> keys;
+    for (const auto& member : map)
+    {
+        keys.push_back(member.first);
+    }
+    return keys;
+}
+}
+
+TEST(test_flat_map, test_insert)
+{
+    map_type map;
+    map["b"] = 2;
+    map["c"] = 3;
+    map["a"] = 1;
+
+    auto result = map.try_emplace(std::string("b"));
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(2, result.first->second);
+
+    EXPECT_EQ(3U, map.size());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), keys(map));
+    EXPECT_EQ(1, map.at("a"));
+    EXPECT_EQ(3, map.find("c")->second);
+    EXPECT_EQ(map.end(), map.find("d"));
+    EXPECT_THROW(map.at("d"), std::out_of_range);
+}
+
+TEST(test_flat_map, test_append_and_sort)
+{
+    map_type map;
+    map.append(std::string("c")) = 1;
+    map.append(std::string("a")) = 2;
+    map.append(std::string("b")) = 3;
+    EXPECT_FALSE(map.sort());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), keys(map));
+
+    // The last value of a duplicate key is kept
+    map.append(std::string("a")) = 4;
+    map.append(std::string("d")) = 5;
+    map.append(std::string("a")) = 6;
+    EXPECT_TRUE(map.sort());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c", "d"}), keys(map));
+    EXPECT_EQ(6, map.at("a"));
+    EXPECT_EQ(5, map.at("d"));
+}
+
+TEST(test_flat_map, test_stable_members)
+{
+    map_type map;
+    int& first = map["m"];
+    first = 1;
+
+    // Inserting members before and after does not move the member
+    for (char c = 'a'; c <= 'z'; ++c)
+    {
+        map[std::string(1, c) + std::string(1, c)] = c;
+    }
+    EXPECT_EQ(&first, &map.at("m"));
+    EXPECT_EQ(1, first);
+
+    map.append(std::string("m")) = 2;
+    map.append(std::string("0")) = 3;
+    EXPECT_TRUE(map.sort());
+    EXPECT_EQ(2, map.at("m"));
+    EXPECT_EQ(3, map.begin()->second);
+    EXPECT_EQ(28U, map.size());
+
+    // Copies do not share members
+    map_type copy(map);
+    EXPECT_EQ(keys(map), keys(copy));
+    EXPECT_NE(&map.at("m"), &copy.at("m"));
+}
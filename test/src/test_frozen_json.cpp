@@ -0,0 +1,135 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <bourne/frozen_json.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_frozen_json, test_freeze)
+{
+    auto value = bourne::json::parse(
+        R"({"server": {"name": "primary", "port": 8080}, "tags": [1, 2]})");
+    auto snapshot = bourne::frozen_json::freeze(value);
+
+    // The snapshot does not change with the value it was frozen from
+    value["server"]["port"] = 9090;
+
+    auto root = snapshot.root();
+    EXPECT_EQ("primary", root["server"]["name"].to_string_view());
+    EXPECT_EQ(8080, root["server"]["port"].to_int());
+    EXPECT_EQ(2, root["tags"][1].to_int());
+    EXPECT_FALSE(root.has_key("missing"));
+    EXPECT_EQ(value.to_tape().size(), snapshot.size());
+
+    // Copies share the tape
+    auto copy = snapshot;
+    EXPECT_EQ(root["server"]["name"].to_string_view().data(),
+              copy.root()["server"]["name"].to_string_view().data());
+
+    EXPECT_TRUE(bourne::frozen_json().root().is_null());
+}
+
+TEST(test_frozen_json, test_atomic_frozen_json)
+{
+    bourne::atomic_frozen_json current;
+    EXPECT_TRUE(current.load().root().is_null());
+
+    bourne::json value = {"version", 1};
+    current.store(bourne::frozen_json::freeze(value));
+
+    auto snapshot = current.load();
+    EXPECT_EQ(1, snapshot.root()["version"].to_int());
+
+    value["version"] = 2;
+    auto previous = current.exchange(bourne::frozen_json::freeze(value));
+    EXPECT_EQ(1, previous.root()["version"].to_int());
+    EXPECT_EQ(2, current.load().root()["version"].to_int());
+
+    // A snapshot loaded before the exchange stays valid
+    EXPECT_EQ(1, snapshot.root()["version"].to_int());
+}
+
+TEST(test_frozen_json, test_concurrent_readers)
+{
+    bourne::json value = {"version", 0, "name", "a long name of a snapshot"};
+    bourne::atomic_frozen_json current(bourne::frozen_json::freeze(value));
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    std::vector<int64_t> last(4, 0);
+    for (std::size_t i = 0; i < last.size(); ++i)
+    {
+        readers.emplace_back(
+            [&current, &done, &last, i]
+            {
+                while (!done)
+                {
+                    auto snapshot = current.load();
+                    auto root = snapshot.root();
+                    int64_t version = root["version"].to_int();
+
+                    // Versions only grow, and every snapshot is complete
+                    EXPECT_LE(last[i], version);
+                    EXPECT_EQ("a long name of a snapshot",
+                              root["name"].to_string_view());
+                    last[i] = version;
+                }
+            });
+    }
+
+    for (int64_t version = 1; version <= 200; ++version)
+    {
+        value["version"] = version;
+        current.store(bourne::frozen_json::freeze(value));
+    }
+    done = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(200, current.load().root()["version"].to_int());
+}
+
+TEST(test_frozen_json, test_concurrent_writers)
+{
+    bourne::atomic_frozen_json current(
+        bourne::frozen_json::freeze(bourne::json{"version", 0}));
+
+    // Every snapshot stored is returned by exactly one exchange, or is the
+    // current one once the writers are done
+    std::vector<std::thread> writers;
+    std::vector<std::vector<int64_t>> replaced(4);
+    for (std::size_t i = 0; i < replaced.size(); ++i)
+    {
+        writers.emplace_back(
+            [&current, &replaced, i]
+            {
+                for (int64_t n = 1; n <= 100; ++n)
+                {
+                    bourne::json value = {"version", int64_t(i) * 100 + n};
+                    auto previous =
+                        current.exchange(bourne::frozen_json::freeze(value));
+                    replaced[i].push_back(
+                        previous.root()["version"].to_int());
+                    current.load();
+                }
+            });
+    }
+    for (auto& writer : writers)
+        writer.join();
+
+    std::vector<int64_t> versions{current.load().root()["version"].to_int()};
+    for (const auto& writer : replaced)
+        versions.insert(versions.end(), writer.begin(), writer.end());
+    std::sort(versions.begin(), versions.end());
+    for (int64_t version = 0; version <= 400; ++version)
+        EXPECT_EQ(version, versions[std::size_t(version)]);
+}
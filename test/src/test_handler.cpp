@@ -0,0 +1,188 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <string>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/handler.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+/// Handler recording every event as a string
+class recorder : public bourne::handler
+{
+public:
+    bool on_null() override
+    {
+        events.push_back("null");
+        return true;
+    }
+
+    bool on_bool(bool value) override
+    {
+        events.push_back(value ? "true" : "false");
+        return true;
+    }
+
+    bool on_int(int64_t value) override
+    {
+        events.push_back("int " + std::to_string(value));
+        return true;
+    }
+
+    bool on_double(double value) override
+    {
+        events.push_back("double " + std::to_string(value));
+        return true;
+    }
+
+    bool on_string(std::string_view value) override
+    {
+        events.push_back("string " + std::string(value));
+        return true;
+    }
+
+    bool on_object_begin() override
+    {
+        events.push_back("{");
+        return true;
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        events.push_back("key " + std::string(key));
+        return true;
+    }
+
+    bool on_object_end() override
+    {
+        events.push_back("}");
+        return true;
+    }
+
+    bool on_array_begin() override
+    {
+        events.push_back("[");
+        return true;
+    }
+
+    bool on_array_end() override
+    {
+        events.push_back("]");
+        return true;
+    }
+
+    std::vector<std::string> events;
+};
+
+/// Handler looking for the value of the first "id" key
+class find_id : public bourne::handler
+{
+public:
+    bool on_key(std::string_view key) override
+    {
+        m_found = key == "id";
+        return true;
+    }
+
+    bool on_int(int64_t value) override
+    {
+        if (!m_found)
+            return true;
+
+        id = value;
+        return false;
+    }
+
+    int64_t id = 0;
+
+private:
+    bool m_found = false;
+};
+}
+
+TEST(test_handler, test_events)
+{
+    std::string json_string = "{\"a\": [1, 2.5, \"text\", true, false, null],"
+                              " \"b\": {}, \"c\": []}";
+
+    recorder handler;
+    std::error_code error;
+    bourne::json::parse(json_string, handler, error);
+    ASSERT_FALSE((bool)error);
+
+    std::vector<std::string> expected = {"{",
+                                         "key a",
+                                         "[",
+                                         "int 1",
+                                         "double 2.500000",
+                                         "string text",
+                                         "true",
+                                         "false",
+                                         "null",
+                                         "]",
+                                         "key b",
+                                         "{",
+                                         "}",
+                                         "key c",
+                                         "[",
+                                         "]",
+                                         "}"};
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(test_handler, test_escaped_strings)
+{
+    recorder handler;
+    bourne::json::parse("{\"k\\\"ey\": \"a\\tb\\u0026\"}", handler);
+
+    std::vector<std::string> expected = {"{", "key k\"ey",
+                                         "string a\tb\\u0026", "}"};
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(test_handler, test_stop)
+{
+    std::string json_string =
+        "{\"meta\": {\"name\": \"x\", \"id\": 42}, \"data\": [1, 2, 3]}";
+
+    find_id handler;
+    std::error_code error;
+    bourne::json::parse(json_string, handler, error);
+    EXPECT_EQ(bourne::error::parse_stopped_by_handler, error);
+    EXPECT_EQ(42, handler.id);
+
+    EXPECT_THROW(bourne::json::parse(json_string, handler), std::system_error);
+}
+
+TEST(test_handler, test_parse_error)
+{
+    recorder handler;
+    std::error_code error;
+    bourne::json::parse("[1, 2 3]", handler, error);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              error);
+
+    std::vector<std::string> expected = {"[", "int 1", "int 2"};
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(test_handler, test_two_stage)
+{
+    std::string json_string = "[ {\"a\" : 1} ,  \"b\"  ]";
+
+    recorder single_stage;
+    bourne::json::parse(json_string, single_stage);
+
+    bourne::json::parse_options options;
+    options.two_stage = true;
+    recorder two_stage;
+    bourne::json::parse(json_string, options, two_stage);
+
+    EXPECT_EQ(single_stage.events, two_stage.events);
+}
@@ -3,6 +3,20 @@
 //
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include <bourne/json.hpp>
 #include <gtest/gtest.h>
 
@@ -172,6 +186,23 @@ TEST(test_json, test_array)
     EXPECT_EQ("[0, 1, 2, 3]", array.dump());
 }
 
+TEST(test_json, test_copy_element)
+{
+    auto array = bourne::json::array("a string too long to be stored inline");
+
+    // Growing the array moves its elements, so the element is copied before
+    // it is assigned
+    array[7] = bourne::json(array[0]);
+    EXPECT_EQ(8U, array.size());
+    EXPECT_EQ("a string too long to be stored inline", array[7].to_string());
+    EXPECT_EQ(array[0], array[7]);
+    EXPECT_TRUE(array[6].is_null());
+
+    // Elements which already exist are not moved
+    array[6] = array[7];
+    EXPECT_EQ(array[0], array[6]);
+}
+
 TEST(test_json, test_nested_array)
 {
     bourne::json array;
@@ -269,6 +300,10 @@ TEST(test_json, test_const_retrival)
         ASSERT_TRUE(json.has_key("test"));
         ASSERT_TRUE(json["test"].is_int());
         EXPECT_EQ(4, json["test"].to_int());
+
+        // Missing keys are not inserted
+        EXPECT_TRUE(json["missing"].is_null());
+        EXPECT_FALSE(json.has_key("missing"));
     };
     const_retrival(obj);
 }
@@ -288,6 +323,22 @@ TEST(test_json, test_keys)
     EXPECT_EQ(4U, obj.keys().size());
 }
 
+TEST(test_json, test_copy_member)
+{
+    auto obj = bourne::json::object();
+    obj["b"] = "a string too long to be stored inline";
+    obj["c"] = 3;
+
+    // Inserting "a" does not move the member assigned to it
+    obj["a"] = obj["b"];
+    EXPECT_EQ("a string too long to be stored inline", obj["a"].to_string());
+    EXPECT_EQ(obj["a"], obj["b"]);
+    EXPECT_EQ(3, obj["c"].to_int());
+
+    obj["c"] = obj["a"];
+    EXPECT_EQ(obj["b"], obj["c"]);
+}
+
 TEST(test_json, test_unicode_dump)
 {
     {
@@ -349,3 +400,511 @@ TEST(test_json, looped_reference)
 
     EXPECT_EQ(1, object["key"].to_int());
 }
+
+TEST(test_json, test_dump_numbers)
+{
+    EXPECT_EQ("2.5", bourne::json(2.5).dump());
+    EXPECT_EQ("0.1", bourne::json(0.1).dump());
+    EXPECT_EQ("100.0", bourne::json(100.0).dump());
+    EXPECT_EQ("-0.0", bourne::json(-0.0).dump());
+    EXPECT_EQ("1e+100", bourne::json(1e100).dump());
+    EXPECT_EQ("1.7976931348623157e+308",
+              bourne::json(1.7976931348623157e308).dump());
+    EXPECT_EQ("null",
+              bourne::json(std::numeric_limits<double>::infinity()).dump());
+    EXPECT_EQ("null",
+              bourne::json(std::numeric_limits<double>::quiet_NaN()).dump());
+
+    EXPECT_EQ("0", bourne::json(0).dump());
+    EXPECT_EQ("-42", bourne::json(-42).dump());
+    EXPECT_EQ("-9223372036854775808", bourne::json(INT64_MIN).dump());
+    EXPECT_EQ("[1.5,-3]", bourne::json::array(1.5, -3).dump_min());
+}
+
+TEST(test_json, test_dump_numbers_round_trip)
+{
+    std::mt19937_64 random(42);
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (value != value || value - value != 0)
+            continue;
+
+        bourne::json number = value;
+        auto result = bourne::json::parse(number.dump());
+        ASSERT_TRUE(result.is_float()) << number.dump();
+
+        double parsed = result.to_float();
+        EXPECT_EQ(0, std::memcmp(&value, &parsed, sizeof(value)))
+            << number.dump();
+    }
+}
+
+
+TEST(test_json, test_dump_to)
+{
+    bourne::json object({"k1", 1, "k2", bourne::json::array(true, "x")});
+
+    std::string output = "prefix ";
+    object.dump_min_to(output);
+    EXPECT_EQ("prefix {\"k1\":1,\"k2\":[true,\"x\"]}", output);
+
+    output.clear();
+    object.dump_to(output);
+    EXPECT_EQ(object.dump(), output);
+
+    output.clear();
+    object.dump_to(output, 1, "\t");
+    EXPECT_EQ("{\n\t\"k1\" : 1,\n\t\"k2\" : [true, \"x\"]\n}", output);
+}
+
+TEST(test_json, test_dump_large)
+{
+    // Larger than the buffer of the serializer
+    std::string long_string(10000, 'a');
+    auto array = bourne::json::array();
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        array.append(i % 100 == 0 ? long_string : "short");
+    }
+
+    auto result = bourne::json::parse(array.dump_min());
+    EXPECT_EQ(array, result);
+}
+
+TEST(test_json, test_dump_escaped_key)
+{
+    bourne::json object({"a\"b\n", 1});
+    EXPECT_EQ("{\"a\\\"b\\n\":1}", object.dump_min());
+    EXPECT_EQ(object, bourne::json::parse(object.dump_min()));
+}
+
+TEST(test_json, test_dump_to_stream)
+{
+    auto object = bourne::json::parse("{\"a\": [1, 2.5, \"x\"], \"b\": null}");
+
+    std::stringstream indented;
+    object.dump_to(indented);
+    EXPECT_EQ(object.dump(), indented.str());
+
+    std::stringstream compact;
+    object.dump_min_to(compact);
+    EXPECT_EQ(object.dump_min(), compact.str());
+
+    std::stringstream stream;
+    stream << object;
+    EXPECT_EQ(object.dump(), stream.str());
+}
+
+TEST(test_json, test_dump_to_function)
+{
+    auto array = bourne::json::array();
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        array.append("element");
+    }
+
+    // The output is passed on in chunks no larger than the buffer
+    std::string output;
+    std::size_t chunks = 0;
+    array.dump_min_to(
+        [&](const char* data, std::size_t size)
+        {
+            EXPECT_LE(size, 4096U);
+            output.append(data, size);
+            chunks++;
+        });
+    EXPECT_EQ(array.dump_min(), output);
+    EXPECT_LT(1U, chunks);
+}
+
+#if !defined(_WIN32)
+TEST(test_json, test_dump_to_fd)
+{
+    auto object = bourne::json::parse("{\"a\": [1, 2, 3], \"b\": \"text\"}");
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+
+    std::error_code error;
+    object.dump_min_to_fd(fileno(file), error);
+    EXPECT_FALSE(error);
+
+    std::rewind(file);
+    std::string output;
+    char buffer[256];
+    std::size_t size;
+    while ((size = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        output.append(buffer, size);
+    }
+    std::fclose(file);
+    EXPECT_EQ(object.dump_min(), output);
+
+    // Writing to an invalid file descriptor fails
+    object.dump_to_fd(-1, error);
+    EXPECT_EQ(std::errc::bad_file_descriptor, error);
+    EXPECT_THROW(object.dump_to_fd(-1), std::system_error);
+}
+#endif
+
+TEST(test_json, test_reserve)
+{
+    auto array = bourne::json::array();
+    array.reserve(100);
+    EXPECT_LE(100U, array.capacity());
+
+    const bourne::json* first = nullptr;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        array.append(i);
+        if (i == 0)
+            first = &array[0];
+    }
+    // The elements were not moved while appending
+    EXPECT_EQ(first, &array[0]);
+
+    array.shrink_to_fit();
+    EXPECT_EQ(100U, array.capacity());
+
+    auto object = bourne::json::object();
+    object.reserve(10);
+    EXPECT_LE(10U, object.capacity());
+    object["a"] = 1;
+    object.shrink_to_fit();
+    EXPECT_EQ(1U, object.capacity());
+}
+
+TEST(test_json, test_parse_array_capacity)
+{
+    auto value = bourne::json::parse("[[1, 2, 3], [], [[4, 5], 6], 7, {\"a\": "
+                                     "[8, 9, 10, 11, 12, 13, 14, 15, 16]}]");
+
+    // Parsed arrays are stored in storage of their final size
+    EXPECT_EQ(5U, value.capacity());
+    EXPECT_EQ(3U, value[0].capacity());
+    EXPECT_EQ(0U, value[1].capacity());
+    EXPECT_EQ(2U, value[2].capacity());
+    EXPECT_EQ(2U, value[2][0].capacity());
+    EXPECT_EQ(9U, value[4]["a"].capacity());
+    EXPECT_EQ(16, value[4]["a"][8].to_int());
+    EXPECT_EQ(bourne::json::parse("[[1, 2, 3], [], [[4, 5], 6], 7, {\"a\": "
+                                  "[8, 9, 10, 11, 12, 13, 14, 15, 16]}]"),
+              value);
+
+    // Growing an array within its capacity keeps references valid
+    value[0].reserve(8);
+    const bourne::json& first = value[0][0];
+    value[0][7] = first;
+    EXPECT_EQ(&first, &value[0][0]);
+    EXPECT_EQ(1, value[0][7].to_int());
+}
+
+TEST(test_json, test_short_strings)
+{
+    EXPECT_LE(sizeof(bourne::json), 16U);
+
+    // Strings around the size stored in the value itself
+    for (std::size_t size = 0; size < 32; ++size)
+    {
+        std::string string(size, 'x');
+        bourne::json value = string;
+        EXPECT_TRUE(value.is_string());
+        EXPECT_EQ(string, value.to_string());
+
+        bourne::json copy = value;
+        EXPECT_EQ(value, copy);
+
+        bourne::json moved = std::move(copy);
+        EXPECT_EQ(string, moved.to_string());
+
+        // Switch between short and long strings
+        moved = std::string(31 - size, 'y');
+        EXPECT_EQ(std::string(31 - size, 'y'), moved.to_string());
+        EXPECT_NE(value, moved);
+
+        auto parsed = bourne::json::parse("[\"" + string + "\"]");
+        EXPECT_EQ(value, parsed[0]);
+        EXPECT_EQ("[\"" + string + "\"]", parsed.dump_min());
+    }
+
+    bourne::json value = "short";
+    value = 42;
+    EXPECT_EQ(42, value.to_int());
+    value = "a string longer than the value";
+    value = true;
+    EXPECT_TRUE(value.to_bool());
+}
+
+TEST(test_json, test_parse_file)
+{
+    std::ifstream test_json("test.json");
+    EXPECT_TRUE(test_json.is_open());
+    std::stringstream buffer;
+    buffer << test_json.rdbuf();
+
+    auto value = bourne::json::parse_file("test.json");
+    EXPECT_EQ(bourne::json::parse(buffer.str()), value);
+    EXPECT_EQ("Jørgen", value["danish_name"].to_string());
+
+    std::error_code error;
+    value = bourne::json::parse_file("missing.json", error);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, error);
+    EXPECT_TRUE(value.is_null());
+    EXPECT_THROW(bourne::json::parse_file("missing.json"), std::system_error);
+}
+
+TEST(test_json, test_borrow_strings)
+{
+    std::string input = "{\"a key longer than inline keys\": "
+                        "[\"a string without escapes\", "
+                        "\"a string with \\\"escapes\\\"\", \"short\"]}";
+
+    bourne::json::parse_options options;
+    options.borrow_strings = true;
+    auto borrowed = bourne::json::parse(input, options);
+    EXPECT_EQ(bourne::json::parse(input), borrowed);
+
+    // Strings without escapes refer to the input
+    const auto& array = borrowed["a key longer than inline keys"];
+    auto view = array[0].to_string_view();
+    EXPECT_EQ("a string without escapes", view);
+    EXPECT_EQ(input.data() + input.find("a string"), view.data());
+    EXPECT_EQ(input.data() + 2,
+              borrowed.object_range().begin()->first.view().data());
+
+    // Strings with escapes are decoded
+    EXPECT_EQ("a string with \"escapes\"", array[1].to_string_view());
+    EXPECT_EQ("short", array[2].to_string_view());
+
+    // Moves keep referring to the input, copies do not
+    bourne::json moved = std::move(borrowed);
+    EXPECT_EQ(view.data(), moved["a key longer than inline keys"][0]
+                               .to_string_view()
+                               .data());
+    bourne::json copy = moved;
+    input.assign(input.size(), ' ');
+    EXPECT_EQ("a string without escapes",
+              copy["a key longer than inline keys"][0].to_string_view());
+    EXPECT_EQ("a key longer than inline keys",
+              copy.object_range().begin()->first);
+}
+
+TEST(test_json, test_copy_borrowed_strings)
+{
+    auto input = std::make_unique<std::string>(
+        R"({"a key longer than inline keys": {"a nested key longer than )"
+        R"(inline keys": ["a string without escapes", [{"deep": )"
+        R"("another string without escapes"}]]}})");
+
+    bourne::json::parse_options options;
+    options.borrow_strings = true;
+    const auto borrowed = bourne::json::parse(*input, options);
+
+    // Copies of values borrowing from the input own their characters, also
+    // in nested objects and arrays, so they outlive the input
+    bourne::json copy = borrowed;
+    bourne::json nested = borrowed["a key longer than inline keys"];
+    input.reset();
+
+    const bourne::json& inner =
+        std::as_const(copy)["a key longer than inline keys"];
+    const bourne::json& array = inner["a nested key longer than inline keys"];
+    EXPECT_EQ("a string without escapes", array[0].to_string_view());
+    EXPECT_EQ("another string without escapes",
+              array[1][0]["deep"].to_string_view());
+    EXPECT_EQ("a key longer than inline keys",
+              copy.object_range().begin()->first);
+    EXPECT_EQ("a nested key longer than inline keys",
+              nested.object_range().begin()->first);
+    EXPECT_EQ(array, std::as_const(nested)["a nested key longer than inline "
+                                           "keys"]);
+}
+
+TEST(test_json, test_copy_built_from_borrowed)
+{
+    auto input = std::make_unique<std::string>(
+        R"({"a key longer than inline keys": ["a string without escapes", )"
+        R"({"a nested key longer than inline keys": "another string"}], )"
+        R"("b": "a third string without escapes"})");
+
+    bourne::json::parse_options options;
+    options.borrow_strings = true;
+    auto borrowed = bourne::json::parse(*input, options);
+
+    // Values borrowing from the input moved and assigned into objects and
+    // arrays built by the user
+    auto built = bourne::json::object();
+    built["array"] = std::move(borrowed["a key longer than inline keys"]);
+    built["string"] = borrowed["b"];
+    auto list = bourne::json::array();
+    list.append(std::move(borrowed));
+    list.append(bourne::json::array(std::move(built)));
+
+    // Copies of the built values own their characters
+    const bourne::json copy = list;
+    list = nullptr;
+    input.reset();
+
+    const bourne::json& nested = copy[1][0];
+    EXPECT_EQ("a string without escapes", nested["array"][0].to_string());
+    EXPECT_EQ("another string",
+              nested["array"][1]["a nested key longer than inline keys"]
+                  .to_string());
+    EXPECT_EQ("a nested key longer than inline keys",
+              nested["array"][1].object_range().begin()->first);
+    EXPECT_EQ("a third string without escapes", nested["string"].to_string());
+    EXPECT_EQ("a third string without escapes", copy[0]["b"].to_string());
+    EXPECT_EQ(2U, copy[0].size());
+}
+
+TEST(test_json, test_copy_keeps_references)
+{
+    bourne::json list = bourne::json::parse(
+        R"(["a string too long to be stored inline", [1, 2], {"a": 1}])");
+
+    // Copies do not share objects and arrays, so references into a value
+    // stay valid while it is copied and modified and the copies destroyed
+    const bourne::json& first = std::as_const(list)[0];
+    const bourne::json& nested = std::as_const(list)[1];
+    bourne::json& object = list[2];
+    {
+        bourne::json copy = list;
+        list[1].append(3);
+        copy[2]["a"] = 2;
+        object["b"] = 3;
+        EXPECT_EQ(2U, copy[1].size());
+        EXPECT_FALSE(copy[2].has_key("b"));
+    }
+    EXPECT_EQ("a string too long to be stored inline", first.to_string());
+    EXPECT_EQ(3U, nested.size());
+    EXPECT_EQ(1, object["a"].to_int());
+    EXPECT_EQ(3, std::as_const(list)[2]["b"].to_int());
+
+    // Long strings are shared, as they are never modified in place
+    bourne::json copy = list;
+    EXPECT_EQ(first.to_string_view().data(),
+              std::as_const(copy)[0].to_string_view().data());
+    EXPECT_FALSE(list.contains(std::as_const(copy)[1]));
+}
+
+TEST(test_json, test_share)
+{
+    const bourne::json original = bourne::json::parse(
+        R"({"name": "a string too long to be stored inline",
+            "list": [1, 2, {"nested": true}], "count": 3})");
+
+    // Shared values share the storage of the original until they are
+    // modified
+    bourne::json shared = original.share();
+    EXPECT_TRUE(original.contains(std::as_const(shared)["list"]));
+
+    shared["list"][2]["nested"] = false;
+    shared["list"].append(4);
+    EXPECT_FALSE(original.contains(std::as_const(shared)["list"]));
+    EXPECT_TRUE(original["list"][2]["nested"].to_bool());
+    EXPECT_EQ(3U, original["list"].size());
+    EXPECT_EQ(4U, shared["list"].size());
+    EXPECT_FALSE(shared["list"][2]["nested"].to_bool());
+
+    // Only the objects and arrays modified are copied
+    EXPECT_EQ(original["name"].to_string_view().data(),
+              std::as_const(shared)["name"].to_string_view().data());
+
+    // Values built through the non-const accessors are shared too
+    bourne::json built;
+    built["list"][0]["a"] = 1;
+    built["count"] = 2;
+    bourne::json built_shared = built.share();
+    EXPECT_TRUE(built.contains(std::as_const(built_shared)["list"]));
+    built["count"] = 3;
+    EXPECT_EQ(2, built_shared["count"].to_int());
+
+    // Iterating mutably copies the shared array first
+    bourne::json list = original["list"].share();
+    for (auto& element : list.array_range())
+    {
+        if (element.is_int())
+            element = element.to_int() * 10;
+    }
+    EXPECT_EQ(10, list[0].to_int());
+    EXPECT_EQ(1, original["list"][0].to_int());
+
+    // The const access operator does not insert missing keys into an object
+    // which may be shared
+    EXPECT_EQ(bourne::json::parse(
+                  R"({"name": "a string too long to be stored inline",
+                      "list": [1, 2, {"nested": true}], "count": 3})"),
+              original);
+}
+
+TEST(test_json, test_share_threads)
+{
+    bourne::json original = bourne::json::parse(
+        R"({"values": [1, 2, 3], "nested": {"key": "a long string value"}})");
+
+    // Values sharing storage are shared, read and modified concurrently
+    std::vector<std::thread> threads;
+    std::vector<bourne::json> results(4);
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back(
+            [&original, &results, i]
+            {
+                const bourne::json& shared = original;
+                for (int j = 0; j < 100; ++j)
+                {
+                    bourne::json copy = shared.share();
+                    copy["values"].append(int64_t(i));
+                    copy["nested"]["key"] = j;
+                    results[i] = copy.share();
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(3U, original["values"].size());
+    EXPECT_EQ("a long string value",
+              original["nested"]["key"].to_string_view());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_EQ(4U, results[i]["values"].size());
+        EXPECT_EQ(int64_t(i), results[i]["values"][3].to_int());
+        EXPECT_EQ(99, results[i]["nested"]["key"].to_int());
+    }
+}
+
+TEST(test_json, test_move_into_containers)
+{
+    static_assert(std::is_nothrow_move_constructible<bourne::json>::value,
+                  "Containers of json values must move them when they grow");
+    static_assert(std::is_nothrow_move_assignable<bourne::json>::value,
+                  "Containers of json values must move them when they grow");
+
+    bourne::json text = std::string(100, 'x');
+    const char* data = std::as_const(text).to_string_view().data();
+
+    // Rvalues are moved into the array instead of copied
+    auto array = bourne::json::array();
+    array.append(std::move(text), 1);
+    EXPECT_TRUE(text.is_null());
+    EXPECT_EQ(data, std::as_const(array)[0].to_string_view().data());
+
+    const std::string_view key = "a long key which does not fit inline";
+    bourne::json& object = array.emplace_back(bourne::class_type::object);
+    object[key] = 2;
+    EXPECT_EQ(3U, array.size());
+    EXPECT_EQ(2, array[2].at(key).to_int());
+    EXPECT_TRUE(array[2].has_key(key));
+    EXPECT_EQ(2, array[2]["a long key which does not fit inline"].to_int());
+
+    bourne::json nested = bourne::json::array(std::move(array), "last");
+    EXPECT_TRUE(array.is_null());
+    EXPECT_EQ(data, std::as_const(nested)[0][0].to_string_view().data());
+    EXPECT_EQ("last", std::as_const(nested)[1].to_string_view());
+}
@@ -0,0 +1,143 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <bourne/json_path.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+// The keys are in sorted order, so the members are selected in the same
+// order from the input and from the parsed value
+const char* input = R"({
+    "events": [
+        {"id": 1, "severity": 2, "tags": ["a"]},
+        {"id": 2, "severity": 5, "tags": ["b", "c"]},
+        {"id": 3, "severity": 4.5},
+        {"id": 4, "severity": "high"},
+        {"id": 5}
+    ],
+    "name": "log",
+    "source": {"host": "server", "id": 6}
+})";
+
+/// Checks that the path selects the expected values, both from the parsed
+/// value and while parsing the input
+void check(const std::string& path, const std::string& expected)
+{
+    SCOPED_TRACE(path);
+    auto compiled = bourne::json_path::parse(path);
+    EXPECT_EQ(path, compiled.to_string());
+
+    EXPECT_EQ(expected, compiled.select(bourne::json::parse(input)).dump_min());
+    EXPECT_EQ(expected, compiled.select_input(input).dump_min());
+}
+}
+
+TEST(test_json_path, test_select)
+{
+    check("$.name", R"(["log"])");
+    check("$['source'][\"host\"]", R"(["server"])");
+    check("$.missing", "[]");
+    check("$.events[0].id", "[1]");
+    check("$.events[-1].id", "[5]");
+    check("$.events[7]", "[]");
+    check("$.events[1:3].id", "[2,3]");
+    check("$.events[::2].id", "[1,3,5]");
+    check("$.events[-2:].id", "[4,5]");
+    check("$.events[::-2].id", "[5,3,1]");
+    check("$.events[*].tags[*]", R"(["a","b","c"])");
+    check("$.source.*", R"(["server",6])");
+    check("$..id", "[1,2,3,4,5,6]");
+    check("$..tags[-1]", R"(["a","c"])");
+    check("$.events[?(@.severity > 3)].id", "[2,3]");
+    check("$.events[?@.severity == 'high'].id", "[4]");
+    check("$.events[?(@.severity != 2)].id", "[2,3,4]");
+    check("$.events[?(@.severity <= 4.5)].id", "[1,3]");
+    check("$.events[?(@.tags)].id", "[1,2]");
+    check("$.events[?(@.tags[1] == \"c\")].id", "[2]");
+    check("$..[?(@.id >= 4)].severity", R"(["high"])");
+    check("$.name[0]", "[]");
+
+    // Values selected inside other values selected
+    check("$..[0]", R"([{"id":1,"severity":2,"tags":["a"]},"a","b"])");
+    check("$..[-1]", R"([{"id":5},"a","c"])");
+}
+
+TEST(test_json_path, test_select_input_same_values)
+{
+    // Values reached through several paths are selected once for each, and
+    // of the members with the same key only the last one is selected from
+    const std::pair<const char*, const char*> queries[] = {
+        {"$..[*]..c", R"([[null,null],{"c":1.5,"a":{"c":{},"sev":)"
+                      R"({"b":1.5,"c":3}}}])"},
+        {"$..*..*", R"({"a":[1,{"b":[2]}]})"},
+        {"$.*", R"({"a":2,"a":{}})"},
+        {"$..a", R"({"a":1,"b":{"a":2,"a":3},"a":{"a":4}})"},
+        {"$.a.b", R"({"a":{"b":1},"a":{}})"},
+        {"$[?(@.x)]", R"({"k":{"x":1},"k":{"y":2},"l":{"x":3}})"},
+        {"$..[-1]", R"({"a":[1,[2,3]],"a":[[4]]})"}};
+
+    for (const auto& query : queries)
+    {
+        SCOPED_TRACE(query.first);
+        auto path = bourne::json_path::parse(query.first);
+
+        // The values may be selected in a different order
+        auto sorted = [](const bourne::json& selected)
+        {
+            std::vector<std::string> values;
+            for (const auto& value : selected.array_range())
+                values.push_back(value.dump_min());
+            std::sort(values.begin(), values.end());
+            return values;
+        };
+        auto expected = sorted(path.select(bourne::json::parse(query.second)));
+        EXPECT_EQ(expected, sorted(path.select_input(query.second)));
+    }
+
+    auto descendants = bourne::json_path::parse("$..[*]..c");
+    EXPECT_EQ(6U, descendants.select_input(queries[0].second).size());
+    EXPECT_EQ("[{}]", bourne::json_path::parse("$.*")
+                          .select_input(R"({"a":2,"a":{}})")
+                          .dump_min());
+}
+
+TEST(test_json_path, test_root)
+{
+    check("$", "[" + bourne::json::parse(input).dump_min() + "]");
+
+    bourne::json_path path;
+    EXPECT_EQ("$", path.to_string());
+    EXPECT_EQ("[1]", path.select(1).dump_min());
+    EXPECT_EQ("[[1]]", path.select_input("[1]").dump_min());
+}
+
+TEST(test_json_path, test_errors)
+{
+    for (const char* path : {"", "events", "$.", "$[", "$['name'", "$[a]",
+                             "$.events[?(@.id > )]", "$[?(@.id > [1])]",
+                             "$[?(id > 1)]", "$.name extra", "$[1:2:x]"})
+    {
+        SCOPED_TRACE(path);
+        std::error_code error;
+        bourne::json_path::parse(path, error);
+        EXPECT_EQ(bourne::error::path_invalid_syntax, error);
+        EXPECT_THROW(bourne::json_path::parse(path), std::system_error);
+    }
+
+    std::error_code error;
+    auto path = bourne::json_path::parse("$.name");
+    auto selected = path.select_input("{\"name\": ", error);
+    EXPECT_TRUE(bool(error));
+    EXPECT_EQ(0U, selected.size());
+}
@@ -0,0 +1,105 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <bourne/detail/key.hpp>
+#include <bourne/detail/key_table.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_key, test_key)
+{
+    EXPECT_LE(sizeof(bourne::detail::key), 16U);
+
+    for (std::size_t size = 0; size < 32; ++size)
+    {
+        std::string string(size, 'k');
+        bourne::detail::key key(string);
+        EXPECT_EQ(string, key);
+        EXPECT_EQ(string, std::string(key));
+        EXPECT_EQ(size, key.size());
+
+        bourne::detail::key copy = key;
+        EXPECT_EQ(key, copy);
+        EXPECT_EQ(size > bourne::detail::key::inline_capacity,
+                  key.shares_buffer(copy));
+
+        bourne::detail::key moved = std::move(copy);
+        EXPECT_EQ(string, moved);
+
+        moved = bourne::detail::key("other");
+        EXPECT_NE(key, moved);
+        EXPECT_EQ(string, key);
+
+        // Copies of borrowed keys own their characters
+        auto borrowed = bourne::detail::key::borrow(string);
+        EXPECT_EQ(key, borrowed);
+        EXPECT_EQ(size > bourne::detail::key::inline_capacity,
+                  borrowed.view().data() == string.data());
+        bourne::detail::key borrowed_copy = borrowed;
+        EXPECT_NE(string.data(), borrowed_copy.view().data());
+        EXPECT_EQ(key, borrowed_copy);
+    }
+}
+
+TEST(test_key, test_key_table)
+{
+    bourne::detail::key_table table;
+    std::string long_key = "a key which is too long to be inline";
+
+    auto first = table.intern(long_key);
+    auto second = table.intern(std::string(long_key));
+    EXPECT_EQ(long_key, first);
+    EXPECT_TRUE(first.shares_buffer(second));
+
+    auto other = table.intern("another key which is too long");
+    EXPECT_FALSE(first.shares_buffer(other));
+}
+
+TEST(test_key, test_parse_intern_keys)
+{
+    std::string input =
+        "[{\"a_long_key_name_for_tests\": 1, \"id\": 2},"
+        " {\"a_long_key_name_for_tests\": 3, \"id\": 4}]";
+
+    bourne::json::parse_options options;
+    options.intern_keys = true;
+    auto interned = bourne::json::parse(input, options);
+    auto result = bourne::json::parse(input);
+    EXPECT_EQ(result, interned);
+
+    auto& first = interned[0].object_range().begin()->first;
+    auto& second = interned[1].object_range().begin()->first;
+    EXPECT_EQ("a_long_key_name_for_tests", first);
+    EXPECT_TRUE(first.shares_buffer(second));
+
+    // Keys are not shared without interning
+    EXPECT_FALSE(result[0].object_range().begin()->first.shares_buffer(
+        result[1].object_range().begin()->first));
+
+    // The keys of one object are found in another object sharing them, by
+    // a linear search and by a binary search
+    std::string object = "{";
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        object += "\"a_long_key_name_number_" + std::to_string(i) + "\": " +
+                  std::to_string(i) + ",";
+    }
+    object.back() = '}';
+    const auto objects =
+        bourne::json::parse("[" + object + "," + object + "]", options);
+    for (const auto& member : objects[0].object_range())
+    {
+        std::string_view key = member.first;
+        EXPECT_TRUE(objects[1].has_key(key));
+        EXPECT_EQ(member.second, objects[1][key]);
+    }
+    const std::string_view key = first;
+    EXPECT_EQ(3, std::as_const(interned)[1][key].to_int());
+}
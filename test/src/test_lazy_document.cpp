@@ -0,0 +1,124 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bourne/class_type.hpp>
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <bourne/lazy_document.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_lazy_document, test_navigate)
+{
+    std::string input = R"({
+        "data": [{"nested": [1, 2, {"deep": "value"}]}, "skipped"],
+        "meta": {"id": 42, "name": "na\"me", "ratio": 0.5, "ok": true},
+        "escaped \"key\"": null,
+        "list": [10, [20, 21], 30]
+    })";
+
+    auto document = bourne::lazy_document::parse(input);
+    auto root = document.root();
+    EXPECT_TRUE(root.is_object());
+    EXPECT_EQ(4U, root.size());
+    EXPECT_EQ(std::vector<std::string>(
+                  {"data", "meta", "escaped \"key\"", "list"}),
+              root.keys());
+
+    auto meta = root["meta"];
+    EXPECT_EQ(42, meta["id"].to_int());
+    EXPECT_TRUE(meta["id"].is_int());
+    EXPECT_EQ("na\\\"me", meta["name"].to_string());
+    EXPECT_DOUBLE_EQ(0.5, meta.at("ratio").to_float());
+    EXPECT_TRUE(meta["ok"].to_bool());
+    EXPECT_FALSE(meta.has_key("missing"));
+    EXPECT_THROW(meta.at("missing"), std::out_of_range);
+
+    EXPECT_TRUE(root["escaped \"key\""].is_null());
+    EXPECT_EQ("value", root["data"][0]["nested"][2]["deep"].to_string());
+    EXPECT_EQ("\"skipped\"", root["data"][1].text());
+    EXPECT_EQ(30, root["list"][2].to_int());
+    EXPECT_EQ(2U, root["list"][1].size());
+    EXPECT_THROW(root["list"].at(3), std::out_of_range);
+
+    // Parsing a value gives the same as parsing the whole input
+    EXPECT_EQ(bourne::json::parse(input)["data"], root["data"].to_json());
+    EXPECT_EQ("[20, 21]", root["list"][1].text());
+}
+
+TEST(test_lazy_document, test_duplicate_keys)
+{
+    auto document = bourne::lazy_document::parse(R"({"a": 1, "a": 2})");
+    EXPECT_EQ(2, document.root()["a"].to_int());
+}
+
+TEST(test_lazy_document, test_ranges)
+{
+    std::string input = R"({"list": [1, [2, 3], {"a": 4}, "five"],
+                            "b": 6.5, "esc\"aped": true, "b": 7, "e": []})";
+    auto document = bourne::lazy_document::parse(input);
+    auto root = document.root();
+
+    std::vector<std::string> texts;
+    for (const auto& element : root["list"].array_range())
+    {
+        texts.push_back(std::string(element.text()));
+    }
+    EXPECT_EQ(std::vector<std::string>({"1", "[2, 3]", "{\"a\": 4}",
+                                        "\"five\""}),
+              texts);
+
+    // Members are visited in the order of the input, duplicates included
+    std::vector<std::string> keys;
+    std::vector<bourne::class_type> types;
+    for (const auto& [key, value] : root.object_range())
+    {
+        keys.push_back(key);
+        types.push_back(value.json_type());
+    }
+    EXPECT_EQ(std::vector<std::string>({"list", "b", "esc\"aped", "b", "e"}),
+              keys);
+    EXPECT_EQ(std::vector<bourne::class_type>(
+                  {bourne::class_type::array, bourne::class_type::floating,
+                   bourne::class_type::boolean, bourne::class_type::integral,
+                   bourne::class_type::array}),
+              types);
+    EXPECT_TRUE((*++root.object_range().begin()).second.is_float());
+
+    auto empty = root["e"].array_range();
+    EXPECT_EQ(empty.begin(), empty.end());
+    auto it = root["list"].array_range().begin();
+    EXPECT_EQ(1, (*it++).to_int());
+    EXPECT_EQ(2U, (*it).size());
+}
+
+TEST(test_lazy_document, test_move)
+{
+    auto document = bourne::lazy_document::parse("[[1, 2], {}]");
+    auto value = document.root()[0];
+
+    // Values stay valid when the document is moved
+    bourne::lazy_document other = std::move(document);
+    EXPECT_EQ(2, value[1].to_int());
+    EXPECT_EQ(0U, other.root()[1].size());
+
+    EXPECT_TRUE(bourne::lazy_document().root().is_null());
+}
+
+TEST(test_lazy_document, test_parse_error)
+{
+    std::error_code error;
+    auto document = bourne::lazy_document::parse("{\"a\": [1, 2}", error);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              error);
+    EXPECT_TRUE(document.root().is_null());
+
+    EXPECT_THROW(bourne::lazy_document::parse("[1,]"), std::system_error);
+}
@@ -0,0 +1,100 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_msgpack, test_round_trip)
+{
+    auto value = bourne::json::parse(
+        R"({"null": null, "bool": [true, false], "int": [0, 127, 128, -32,
+            -33, -129, 65536, -9223372036854775808, 9223372036854775807],
+            "float": [1.5, 0.1, -2.0e300], "string": ["", "short",
+            "a string which is longer than thirty one bytes"],
+            "nested": {"empty_array": [], "empty_object": {}}})");
+
+    auto encoded = value.to_msgpack();
+    auto decoded = bourne::json::from_msgpack(encoded);
+    EXPECT_EQ(value, decoded);
+    EXPECT_TRUE(decoded["float"][0].is_float());
+    EXPECT_TRUE(decoded["int"][0].is_int());
+
+    std::vector<uint8_t> output;
+    value.to_msgpack(output);
+    EXPECT_EQ(encoded, output);
+}
+
+TEST(test_msgpack, test_encoding)
+{
+    using bytes = std::vector<uint8_t>;
+
+    EXPECT_EQ(bytes({0x7f}), bourne::json(127).to_msgpack());
+    EXPECT_EQ(bytes({0xcc, 0x80}), bourne::json(128).to_msgpack());
+    EXPECT_EQ(bytes({0xcd, 0x01, 0x00}), bourne::json(256).to_msgpack());
+    EXPECT_EQ(bytes({0xe0}), bourne::json(-32).to_msgpack());
+    EXPECT_EQ(bytes({0xd0, 0xdf}), bourne::json(-33).to_msgpack());
+    EXPECT_EQ(bytes({0xd1, 0xff, 0x7f}), bourne::json(-129).to_msgpack());
+    EXPECT_EQ(bytes({0xca, 0x3f, 0xc0, 0x00, 0x00}),
+              bourne::json(1.5).to_msgpack());
+    EXPECT_EQ(bytes({0xc0}), bourne::json(nullptr).to_msgpack());
+    EXPECT_EQ(bytes({0xc2}), bourne::json(false).to_msgpack());
+    EXPECT_EQ(bytes({0xa1, 0x61}), bourne::json("a").to_msgpack());
+    EXPECT_EQ(bytes({0x93, 0x01, 0x02, 0x03}),
+              bourne::json::array(1, 2, 3).to_msgpack());
+    EXPECT_EQ(bytes({0x81, 0xa1, 0x61, 0x01}),
+              bourne::json::parse(R"({"a": 1})").to_msgpack());
+
+    // Encodings which are not written are decoded as well
+    EXPECT_EQ(-1, bourne::json::from_msgpack(
+                      bytes({0xd2, 0xff, 0xff, 0xff, 0xff}))
+                      .to_int());
+    EXPECT_EQ(
+        1, bourne::json::from_msgpack(bytes({0xcd, 0x00, 0x01})).to_int());
+    EXPECT_EQ(bourne::json::array(1),
+              bourne::json::from_msgpack(bytes({0xdc, 0x00, 0x01, 0x01})));
+
+    // Integers which do not fit in an int64_t are decoded as floating point
+    auto large = bourne::json::from_msgpack(
+        bytes({0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+    EXPECT_TRUE(large.is_float());
+    EXPECT_DOUBLE_EQ(18446744073709551615.0, large.to_float());
+}
+
+TEST(test_msgpack, test_errors)
+{
+    using bytes = std::vector<uint8_t>;
+
+    auto decode = [](const bytes& data)
+    {
+        std::error_code error;
+        auto value = bourne::json::from_msgpack(data, error);
+        EXPECT_TRUE(value.is_null());
+        return error;
+    };
+
+    EXPECT_EQ(bourne::error::decode_unexpected_end, decode(bytes()));
+    EXPECT_EQ(bourne::error::decode_unexpected_end, decode(bytes({0xcd})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0x93, 0x01})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0xa5, 0x61})));
+    EXPECT_EQ(bourne::error::decode_trailing_bytes,
+              decode(bytes({0x01, 0x02})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type,
+              decode(bytes({0xc4, 0x00})));
+    EXPECT_EQ(bourne::error::decode_unsupported_type, decode(bytes({0xc1})));
+    EXPECT_EQ(bourne::error::decode_key_not_string,
+              decode(bytes({0x81, 0x01, 0x01})));
+    EXPECT_EQ(bourne::error::decode_unexpected_end,
+              decode(bytes({0xdd, 0xff, 0xff, 0xff, 0xff, 0x01})));
+
+    EXPECT_THROW(bourne::json::from_msgpack(bytes({0xcd})), std::system_error);
+}
@@ -0,0 +1,87 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <bourne/ndjson_parser.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_ndjson_parser, test_parse)
+{
+    std::string input = "{\"id\": 1}\n"
+                        "\n"
+                        "[1, 2\n"
+                        "  \"three\"  \r\n"
+                        "4";
+
+    bourne::ndjson_parser::options options;
+    options.threads = 1;
+    bourne::ndjson_parser parser(options);
+    auto records = parser.parse(input);
+
+    ASSERT_EQ(4U, records.size());
+    EXPECT_EQ(1U, records[0].line);
+    EXPECT_EQ(1, records[0].value["id"].to_int());
+    EXPECT_FALSE(records[0].error);
+
+    // Errors are reported for the line and parsing continues
+    EXPECT_EQ(3U, records[1].line);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              records[1].error);
+    EXPECT_TRUE(records[1].value.is_null());
+
+    EXPECT_EQ(4U, records[2].line);
+    EXPECT_EQ("three", records[2].value.to_string());
+    EXPECT_EQ(5U, records[3].line);
+    EXPECT_EQ(4, records[3].value.to_int());
+}
+
+TEST(test_ndjson_parser, test_parse_parallel)
+{
+    std::string input;
+    for (int i = 0; i < 10000; ++i)
+    {
+        input += i % 100 == 99 ? "{\"invalid\"}\n"
+                               : "{\"id\": " + std::to_string(i) + "}\n";
+    }
+
+    // Small chunks give every thread many chunks to parse
+    bourne::ndjson_parser::options options;
+    options.threads = 4;
+    options.chunk_size = 256;
+    bourne::ndjson_parser parser(options);
+
+    std::size_t count = 0;
+    parser.parse(input,
+                 [&count](bourne::ndjson_parser::record&& record)
+                 {
+                     EXPECT_EQ(count + 1, record.line);
+                     if (count % 100 == 99)
+                     {
+                         EXPECT_EQ(bourne::error::parse_object_expected_colon,
+                                   record.error);
+                     }
+                     else
+                     {
+                         EXPECT_EQ(int64_t(count), record.value["id"].to_int());
+                     }
+                     count++;
+                 });
+    EXPECT_EQ(10000U, count);
+
+    // Exceptions thrown by the function stop the parsing
+    EXPECT_THROW(parser.parse(input,
+                              [](bourne::ndjson_parser::record&&)
+                              { throw std::runtime_error("stop"); }),
+                 std::runtime_error);
+
+    // The parser can be reused
+    EXPECT_EQ(10000U, parser.parse(input).size());
+}
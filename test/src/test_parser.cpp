@@ -3,7 +3,14 @@
 //
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <bourne/detail/parser.hpp>
 #include <bourne/json.hpp>
@@ -254,3 +261,219 @@ TEST(test_parser, test_parse_nested_object_duplicate_key_strict)
         << error.message();
     ASSERT_EQ(bourne::json::null(), result);
 }
+
+TEST(test_parser, test_parse_object_key_not_string_error)
+{
+    auto expected_error = bourne::error::parse_next_unexpected_char;
+    std::error_code error;
+    std::string json_string = "{1: 2}";
+    auto result = bourne::detail::parser::parse(json_string, error);
+    EXPECT_EQ(expected_error, error) << error.message();
+    ASSERT_EQ(bourne::json::null(), result);
+}
+
+TEST(test_parser, test_parse_string_expected_closing_quote_error)
+{
+    auto expected_error = bourne::error::parse_string_expected_closing_quote;
+    std::error_code error;
+    std::string json_string = "{\"bourne\": \"unterminated\\\"}";
+    auto result = bourne::detail::parser::parse(json_string, error);
+    EXPECT_EQ(expected_error, error) << error.message();
+    ASSERT_EQ(bourne::json::null(), result);
+}
+
+TEST(test_parser, test_parse_string_view)
+{
+    // Only the first part of the buffer is parsed, the rest is not json
+    std::string buffer = "{\"a\": [true, false, null]}garbage";
+    std::string_view input(buffer.data(), buffer.size() - 7);
+
+    auto expected =
+        bourne::json{"a", bourne::json::array(true, false, nullptr)};
+    EXPECT_EQ(expected, bourne::json::parse(input));
+    EXPECT_EQ(expected, bourne::json::parse(buffer.data(), input.size()));
+
+    std::error_code error;
+    bourne::json::parse(buffer.data(), buffer.size(), error);
+    EXPECT_EQ(bourne::error::parse_found_multiple_unstructured_elements,
+              error);
+}
+
+TEST(test_parser, test_parse_string_view_bounds)
+{
+    // The parser must not read past the end of the range
+    std::string buffer = "[1, null, true]";
+    std::error_code error;
+
+    bourne::json::parse(buffer.data(), 4, error);
+    EXPECT_EQ(bourne::error::parse_next_unexpected_char, error);
+
+    error.clear();
+    bourne::json::parse(buffer.data(), 6, error);
+    EXPECT_EQ(bourne::error::parse_null_expected_null, error);
+
+    error.clear();
+    bourne::json::parse(buffer.data() + 10, 3, error);
+    EXPECT_EQ(bourne::error::parse_boolean_expected_true_or_false, error);
+
+    error.clear();
+    bourne::json::parse(buffer.data(), 1, error);
+    EXPECT_EQ(bourne::error::parse_next_unexpected_char, error);
+}
+
+TEST(test_parser, test_parse_numbers)
+{
+    EXPECT_EQ(bourne::json(753), bourne::json::parse("753"));
+    EXPECT_EQ(bourne::json(-42), bourne::json::parse("-42"));
+    EXPECT_EQ(bourne::json(0), bourne::json::parse("-0"));
+    EXPECT_EQ(bourne::json(INT64_MAX),
+              bourne::json::parse("9223372036854775807"));
+    EXPECT_EQ(bourne::json(INT64_MIN),
+              bourne::json::parse("-9223372036854775808"));
+
+    // Integers which do not fit in an int64_t are stored as doubles
+    auto big = bourne::json::parse("9223372036854775808");
+    ASSERT_TRUE(big.is_float());
+    EXPECT_EQ(9223372036854775808.0, big.to_float());
+    big = bourne::json::parse("123456789012345678901234567890");
+    ASSERT_TRUE(big.is_float());
+    EXPECT_EQ(1.2345678901234568e29, big.to_float());
+
+    // Numbers with an exponent are always floating point
+    EXPECT_EQ(bourne::json(100.0), bourne::json::parse("1e2"));
+    EXPECT_EQ(bourne::json(0.01), bourne::json::parse("1e-2"));
+    EXPECT_EQ(bourne::json(-250.0), bourne::json::parse("-2.5E+2"));
+    EXPECT_EQ(bourne::json(0.0), bourne::json::parse("1e-400"));
+}
+
+TEST(test_parser, test_parse_numbers_round_trip)
+{
+    // Doubles written with 17 significant digits must parse to the exact
+    // same bits, including values which need the slow path.
+    std::vector<double> values = {0.1,
+                                  1.0 / 3.0,
+                                  2.2250738585072014e-308,
+                                  4.9406564584124654e-324,
+                                  1.7976931348623157e308,
+                                  9007199254740993.0,
+                                  123456.789e-20,
+                                  -6.02214076e23};
+    for (double value : values)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.17g", value);
+        auto result = bourne::json::parse(text);
+        ASSERT_TRUE(result.is_float()) << text;
+        EXPECT_EQ(value, result.to_float()) << text;
+    }
+}
+
+TEST(test_parser, test_numbers_locale)
+{
+    // Numbers are read and written with a decimal point whatever the locale
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    const char* names[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8",
+                           "fr_FR.utf8", "fr_FR", "German"};
+    const char* name = nullptr;
+    for (const char* candidate : names)
+    {
+        if (std::setlocale(LC_NUMERIC, candidate) != nullptr)
+        {
+            name = candidate;
+            break;
+        }
+    }
+    if (name == nullptr || *std::localeconv()->decimal_point != ',')
+    {
+        std::setlocale(LC_NUMERIC, previous.c_str());
+        GTEST_SKIP() << "No locale with a decimal comma is installed";
+    }
+
+    EXPECT_EQ(1.5, bourne::json::parse("1.5").to_float());
+    EXPECT_EQ(4.9406564584124654e-324,
+              bourne::json::parse("4.9406564584124654e-324").to_float());
+    EXPECT_EQ(1.2345678901234568e29,
+              bourne::json::parse("123456789012345678901234567890.5")
+                  .to_float());
+    EXPECT_EQ("1.5", bourne::json(1.5).dump_min());
+    EXPECT_EQ("[0.1,2.0]", bourne::json::array(0.1, 2.0).dump_min());
+
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
+
+TEST(test_parser, test_parse_number_errors)
+{
+    std::vector<std::pair<std::string, bourne::error>> inputs = {
+        {"-", bourne::error::parse_number_expected_number_for_component},
+        {"[1.]", bourne::error::parse_number_expected_number_for_component},
+        {"[.5]", bourne::error::parse_next_unexpected_char},
+        {"[1e+]", bourne::error::parse_number_expected_number_for_component},
+        {"[01]", bourne::error::parse_number_unexpected_char},
+        {"[1-2]", bourne::error::parse_number_unexpected_char},
+        {"1e400", bourne::error::parse_number_out_of_range},
+        {"-1e400", bourne::error::parse_number_out_of_range}};
+
+    for (const auto& input : inputs)
+    {
+        std::error_code error;
+        bourne::json::parse(input.first, error);
+        EXPECT_EQ(input.second, error) << input.first;
+    }
+}
+
+TEST(test_parser, test_parse_object_unordered_keys)
+{
+    std::string json_string = "{\"d\":4,\"b\":2,\"c\":3,\"a\":1,\"b\":5}";
+    auto result = bourne::json::parse(json_string);
+    EXPECT_EQ(4U, result.size());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c", "d"}), result.keys());
+    EXPECT_EQ(5, result["b"].to_int());
+
+    // Many members in reverse order, with a duplicate key at the end
+    std::vector<std::string> keys;
+    json_string = "{";
+    for (uint32_t i = 100; i-- > 0;)
+    {
+        keys.insert(keys.begin(), "key" + std::to_string(100 + i));
+        json_string += "\"" + keys.front() + "\":" + std::to_string(i) + ",";
+    }
+    json_string += "\"key150\":-1}";
+
+    result = bourne::json::parse(json_string);
+    EXPECT_EQ(keys, result.keys());
+    EXPECT_EQ(-1, result["key150"].to_int());
+    EXPECT_EQ(20, result["key120"].to_int());
+
+    std::error_code error;
+    bourne::json::parse_options options;
+    options.strict = true;
+    bourne::json::parse(json_string, options, error);
+    EXPECT_EQ(bourne::error::parse_object_duplicate_key, error);
+
+    // Duplicate keys are found as the members are parsed, before the syntax
+    // errors after them
+    json_string.back() = ',';
+    json_string += "1}";
+    error.clear();
+    bourne::json::parse(json_string, options, error);
+    EXPECT_EQ(bourne::error::parse_object_duplicate_key, error);
+}
+
+TEST(test_parser, test_parse_reserves_containers)
+{
+    std::string json_string = "[";
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        json_string += std::to_string(i) + ",";
+    }
+    json_string += "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5}]";
+
+    // The two stage parser knows the sizes in advance from the index
+    bourne::json::parse_options options;
+    options.two_stage = true;
+    auto result = bourne::json::parse(json_string, options);
+    EXPECT_EQ(1001U, result.size());
+    EXPECT_EQ(1001U, result.capacity());
+    EXPECT_EQ(5U, result[1000].capacity());
+    EXPECT_EQ(bourne::json::parse(json_string), result);
+}
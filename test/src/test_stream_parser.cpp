@@ -0,0 +1,185 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <bourne/error.hpp>
+#include <bourne/handler.hpp>
+#include <bourne/json.hpp>
+#include <bourne/stream_parser.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+/// Parses the input in chunks of the given size
+bourne::json parse_chunked(const std::string& input, std::size_t chunk_size,
+                           std::error_code& error)
+{
+    bourne::stream_parser parser;
+    for (std::size_t offset = 0; offset < input.size() && !error;
+         offset += chunk_size)
+    {
+        parser.feed(input.data() + offset,
+                    std::min(chunk_size, input.size() - offset), error);
+    }
+    if (error)
+        return bourne::json();
+
+    parser.finish(error);
+    if (error)
+        return bourne::json();
+    return parser.release();
+}
+
+/// Checks that every chunk size gives the same result as json::parse
+void test_chunks(const std::string& input)
+{
+    SCOPED_TRACE(input);
+    std::error_code expected_error;
+    auto expected = bourne::json::parse(input, expected_error);
+
+    for (std::size_t chunk_size = 1; chunk_size <= input.size() + 1;
+         ++chunk_size)
+    {
+        SCOPED_TRACE(chunk_size);
+        std::error_code error;
+        auto result = parse_chunked(input, chunk_size, error);
+        EXPECT_EQ(expected_error, error);
+        EXPECT_EQ(expected, result);
+    }
+}
+}
+
+TEST(test_stream_parser, test_parse)
+{
+    test_chunks("753 ");
+    test_chunks(" 90200.10 ");
+    test_chunks("\"Text String\"");
+    test_chunks("\"you are a \\\"great\\\" agent\\/spy\"");
+    test_chunks("\"escapes \\u0026 \\n\\t\\\\\"");
+    test_chunks("[1, 2,3]");
+    test_chunks("[true, false, null, -4 , 0.25 ,-2.5]");
+    test_chunks("[1e2, -2.5E-1, 3e+2 ,0.1e1]");
+    test_chunks("{\"value\":3}");
+    test_chunks("{ \"key1\" : \"value\", \"key2\" : [ {}, [], {\"a\": {}} ] }");
+    test_chunks(" \n\t[ ] \r\n");
+}
+
+TEST(test_stream_parser, test_parse_errors)
+{
+    test_chunks("");
+    test_chunks("   ");
+    test_chunks("753");
+    test_chunks(" 75..3 ");
+    test_chunks("[1, 2 3]");
+    test_chunks("[1, 2,");
+    test_chunks("{\"a\" 1}");
+    test_chunks("{\"a\": 1 \"b\": 2}");
+    test_chunks("{\"a\": 1,");
+    test_chunks("{1: 2}");
+    test_chunks("\"abc");
+    test_chunks("\"\\u12x4\"");
+    test_chunks("\"\\u12");
+    test_chunks("[1x]");
+    test_chunks("[1e ]");
+    test_chunks("[01]");
+    test_chunks("[tru]");
+    test_chunks("[nul");
+    test_chunks("{} {}");
+    test_chunks("[\"a\"] x");
+}
+
+TEST(test_stream_parser, test_parse_file)
+{
+    std::ifstream test_json("test.json");
+    EXPECT_TRUE(test_json.is_open());
+
+    std::stringstream buffer;
+    buffer << test_json.rdbuf();
+    std::string input = buffer.str();
+
+    for (std::size_t chunk_size : {1U, 7U, 64U, 4096U})
+    {
+        std::error_code error;
+        auto result = parse_chunked(input, chunk_size, error);
+        ASSERT_FALSE((bool)error);
+        EXPECT_EQ(bourne::json::parse(input), result);
+    }
+}
+
+TEST(test_stream_parser, test_is_complete)
+{
+    bourne::stream_parser parser;
+    std::string input = "{\"a\": [1, 2]";
+    parser.feed(input.data(), input.size());
+    EXPECT_FALSE(parser.is_complete());
+
+    parser.feed("}", 1);
+    EXPECT_TRUE(parser.is_complete());
+
+    parser.feed(" \n", 2);
+    parser.finish();
+    EXPECT_EQ(bourne::json::parse(input + "}"), parser.release());
+}
+
+TEST(test_stream_parser, test_errors_are_kept)
+{
+    bourne::stream_parser parser;
+    std::error_code error;
+    parser.feed("[1 2", 4, error);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              error);
+
+    error.clear();
+    parser.feed("]", 1, error);
+    EXPECT_EQ(bourne::error::parse_array_expected_comma_or_closing_bracket,
+              error);
+
+    EXPECT_THROW(parser.finish(), std::system_error);
+}
+
+TEST(test_stream_parser, test_strict)
+{
+    bourne::json::parse_options options;
+    options.strict = true;
+    bourne::stream_parser parser(options);
+
+    std::string input = "{\"a\": 1, \"a\": 2}";
+    std::error_code error;
+    for (char c : input)
+    {
+        parser.feed(&c, 1, error);
+        if (error)
+            break;
+    }
+    EXPECT_EQ(bourne::error::parse_object_duplicate_key, error);
+}
+
+TEST(test_stream_parser, test_handler)
+{
+    class counter : public bourne::handler
+    {
+    public:
+        bool on_int(int64_t value) override
+        {
+            sum += value;
+            return true;
+        }
+
+        int64_t sum = 0;
+    };
+
+    counter handler;
+    bourne::stream_parser parser(handler);
+    parser.feed("[1, 2", 5);
+    parser.feed("0, 3", 4);
+    parser.feed("00]", 3);
+    parser.finish();
+    EXPECT_EQ(321, handler.sum);
+}
@@ -0,0 +1,144 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <bourne/detail/parser.hpp>
+#include <bourne/detail/simd.hpp>
+#include <bourne/detail/structural_index.hpp>
+#include <bourne/json.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<bourne::detail::instruction_set> instruction_sets()
+{
+    return {bourne::detail::instruction_set::scalar,
+            bourne::detail::instruction_set::sse2,
+            bourne::detail::instruction_set::avx2,
+            bourne::detail::instruction_set::neon};
+}
+
+void test_two_stage(const std::string& json_string)
+{
+    bourne::json::parse_options options;
+    std::error_code error;
+    auto expected = bourne::detail::parser::parse(json_string, options, error);
+
+    options.two_stage = true;
+    std::error_code two_stage_error;
+    auto result =
+        bourne::detail::parser::parse(json_string, options, two_stage_error);
+
+    EXPECT_EQ(error, two_stage_error) << "Input: '" << json_string << "'";
+    EXPECT_EQ(expected, result) << "Input: '" << json_string << "'";
+}
+}
+
+TEST(test_structural_index, test_classifiers)
+{
+    auto scalar =
+        bourne::detail::classifier(bourne::detail::instruction_set::scalar);
+    ASSERT_NE(nullptr, scalar);
+    EXPECT_NE(nullptr,
+              bourne::detail::classifier(bourne::detail::best_instruction_set()));
+
+    std::string alphabet = "{}[]:,\"\\ \t\n\v\f\rab01-.\x80\xff";
+    for (auto set : instruction_sets())
+    {
+        auto classify = bourne::detail::classifier(set);
+        if (classify == nullptr)
+            continue;
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            std::string block;
+            for (std::size_t j = 0; j < bourne::detail::block_size; ++j)
+            {
+                block += alphabet[rand() % alphabet.size()];
+            }
+
+            auto expected = scalar(block.data());
+            auto masks = classify(block.data());
+            EXPECT_EQ(expected.quote, masks.quote);
+            EXPECT_EQ(expected.backslash, masks.backslash);
+            EXPECT_EQ(expected.white_space, masks.white_space);
+            EXPECT_EQ(expected.structural, masks.structural);
+        }
+    }
+}
+
+TEST(test_structural_index, test_offsets)
+{
+    std::string input = "{ \"a\\\"]\" : [1, true ,\"\\\\\"], \"b\":null }";
+    bourne::detail::structural_index index(input.data(), input.size());
+
+    std::vector<uint32_t> expected = {0,  2,  9,  11, 12, 13, 15, 20,
+                                      21, 25, 26, 28, 31, 32, 37, 38};
+    EXPECT_EQ(expected, index.offsets());
+}
+
+TEST(test_structural_index, test_container_sizes)
+{
+    std::string input =
+        "{\"a\": [], \"b\": [1, [2, 3], {}], \"c\": \"[,]\", \"d\": {\"e\": 4}}";
+    bourne::detail::structural_index index(input.data(), input.size());
+
+    std::vector<uint32_t> expected = {4, 0, 3, 2, 0, 1};
+    EXPECT_EQ(expected, index.container_sizes());
+}
+
+TEST(test_structural_index, test_offsets_across_blocks)
+{
+    // Strings and escapes crossing the block boundaries
+    std::string input = "[\"" + std::string(62, 'x') + "\\\"" +
+                        std::string(63, 'y') + "\\\\\", " +
+                        std::string(70, ' ') + "42]";
+
+    for (auto set : instruction_sets())
+    {
+        auto classify = bourne::detail::classifier(set);
+        if (classify == nullptr)
+            continue;
+
+        bourne::detail::structural_index index(input.data(), input.size(),
+                                               classify);
+        std::vector<uint32_t> expected = {
+            0, 1, uint32_t(input.find(',')), uint32_t(input.find('4')),
+            uint32_t(input.size() - 1), uint32_t(input.size())};
+        EXPECT_EQ(expected, index.offsets());
+    }
+}
+
+TEST(test_structural_index, test_two_stage_parse)
+{
+    test_two_stage("753 ");
+    test_two_stage(" 75..3 ");
+    test_two_stage(" 90200.10 ");
+    test_two_stage("\"you are a \\\"great\\\" agent\\/spy\"");
+    test_two_stage("[1, 2,3]");
+    test_two_stage("{ \"key1\" : \"value\",  \"key2\" : true, "
+                   "  \"key3\" : 1234,   \"key4\" : -42,   \"key5\" : null }");
+    test_two_stage("{} 1  ");
+    test_two_stage("{\"bourne\"}");
+    test_two_stage("{\"bourne\": 1 :}");
+    test_two_stage("{\"bourne\": [0 0}");
+    test_two_stage("{\"bourne\": \"\\uG\"}");
+    test_two_stage("{\"bourne\": 1e}");
+    test_two_stage("{\"bourne\": 123a}");
+    test_two_stage("{\"bourne\": foo}");
+    test_two_stage("{\"bourne\": nut}");
+    test_two_stage("]");
+    test_two_stage("\"unterminated");
+    test_two_stage("[\"unterminated\\");
+    test_two_stage("[1e\"5 ,\"x\"]");
+
+    std::string padding(100, ' ');
+    test_two_stage(padding + "{\"a\":" + padding + "[" + padding + "true," +
+                   padding + "\"" + padding + "\"]" + padding + "}" +
+                   padding);
+}
@@ -0,0 +1,163 @@
+// Copyright (c) Steinwurf ApS 2016.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bourne/class_type.hpp>
+#include <bourne/error.hpp>
+#include <bourne/json.hpp>
+#include <bourne/tape_document.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+const char* input = R"({
+    "name": "server",
+    "description": "A string which does not fit in a tape node",
+    "port": 8080,
+    "ratio": 0.25,
+    "enabled": true,
+    "parent": null,
+    "tags": ["a", "b", "\"quoted\""],
+    "limits": {"cpu": 2, "memory": 4096, "": []}
+})";
+}
+
+TEST(test_tape_document, test_root)
+{
+    auto value = bourne::json::parse(input);
+    auto document = bourne::tape_document::from_json(value);
+    auto root = document.root();
+
+    EXPECT_TRUE(root.is_object());
+    EXPECT_EQ(8U, root.size());
+    EXPECT_EQ("server", root["name"].to_string_view());
+    EXPECT_EQ("A string which does not fit in a tape node",
+              root["description"].to_string_view());
+    EXPECT_EQ(8080, root["port"].to_int());
+    EXPECT_TRUE(root["port"].is_float());
+    EXPECT_EQ(8080.0, root["port"].to_float());
+    EXPECT_EQ(0.25, root["ratio"].to_float());
+    EXPECT_FALSE(root["ratio"].is_int());
+    EXPECT_TRUE(root["enabled"].to_bool());
+    EXPECT_TRUE(root["parent"].is_null());
+    EXPECT_EQ(3U, root["tags"].size());
+    EXPECT_EQ("\\\"quoted\\\"", root["tags"][2].to_string());
+    EXPECT_EQ(4096, root.at("limits").at("memory").to_int());
+    EXPECT_TRUE(root["limits"][""].is_array());
+    EXPECT_FALSE(root.has_key("missing"));
+    EXPECT_THROW(root.at("missing"), std::out_of_range);
+    EXPECT_THROW(root["tags"].at(3), std::out_of_range);
+
+    std::vector<std::string_view> keys = {"", "cpu", "memory"};
+    EXPECT_EQ(keys, root["limits"].keys());
+
+    EXPECT_EQ(value, root.to_json());
+    EXPECT_EQ(value["tags"], root["tags"].to_json());
+
+    // Values stay valid when the document is moved
+    auto tags = root["tags"];
+    auto moved = std::move(document);
+    EXPECT_EQ("a", tags[0].to_string_view());
+
+    EXPECT_TRUE(bourne::tape_document().root().is_null());
+}
+
+TEST(test_tape_document, test_open)
+{
+    auto value = bourne::json::parse(input);
+    std::string path = "test_tape_document.tape";
+    {
+        auto tape = value.to_tape();
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(tape.data()), tape.size());
+    }
+
+    auto document = bourne::tape_document::open(path);
+    EXPECT_EQ(value, document.root().to_json());
+    EXPECT_EQ("cpu", document.root()["limits"].keys()[1]);
+    std::remove(path.c_str());
+
+    std::error_code error;
+    bourne::tape_document::open(path, error);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, error);
+}
+
+TEST(test_tape_document, test_invalid)
+{
+    auto tape = bourne::json::parse(input).to_tape();
+
+    std::error_code error;
+    bourne::tape_document::load(tape.data(), 20, error);
+    EXPECT_EQ(bourne::error::decode_invalid_tape, error);
+    error.clear();
+
+    auto corrupt = tape;
+    corrupt[0] = 'x';
+    bourne::tape_document::load(corrupt.data(), corrupt.size(), error);
+    EXPECT_EQ(bourne::error::decode_invalid_tape, error);
+
+    // A truncated tape is only found when the missing values are read
+    auto document = bourne::tape_document::load(tape.data(), 64);
+    EXPECT_TRUE(document.root().is_object());
+    EXPECT_THROW(document.root().to_json(), std::system_error);
+
+    // Children must be stored after their parent
+    corrupt = tape;
+    corrupt[24] = 0;
+    document = bourne::tape_document::load(corrupt.data(), corrupt.size());
+    EXPECT_THROW(document.root().keys(), std::system_error);
+}
+
+TEST(test_tape_document, test_shared_children)
+{
+    // A corrupt tape of nested arrays whose two elements share one child
+    // table, so a tree read from it would have 2^depth nodes
+    const uint32_t depth = 48;
+    std::vector<uint8_t> tape = bourne::json().to_tape();
+    tape.resize(16 + 16 + depth * 32 + 32);
+
+    auto store = [&tape](std::size_t offset, uint8_t type, uint32_t size,
+                         uint64_t payload)
+    {
+        tape[offset] = type;
+        for (int i = 0; i < 4; ++i)
+            tape[offset + 4 + i] = uint8_t(size >> (8 * i));
+        for (int i = 0; i < 8; ++i)
+            tape[offset + 8 + i] = uint8_t(payload >> (8 * i));
+    };
+
+    const auto array = uint8_t(bourne::class_type::array);
+    store(16, array, 2, 32);
+    for (uint32_t level = 0; level < depth; ++level)
+    {
+        const std::size_t table = 32 + level * 32;
+        store(table, array, 2, table + 32);
+        store(table + 16, array, 2, table + 32);
+    }
+    const auto null = uint8_t(bourne::class_type::null);
+    store(32 + depth * 32, null, 0, 0);
+    store(32 + depth * 32 + 16, null, 0, 0);
+
+    auto document = bourne::tape_document::load(tape.data(), tape.size());
+    EXPECT_EQ(2U, document.root()[1][1][0].size());
+    try
+    {
+        document.root().to_json();
+        FAIL() << "The shared child tables were not detected";
+    }
+    catch (const std::system_error& error)
+    {
+        EXPECT_EQ(bourne::error::decode_invalid_tape, error.code());
+    }
+}